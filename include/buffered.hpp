@@ -0,0 +1,234 @@
+//
+// Created by HP on 19.10.2026.
+//
+
+#ifndef BUFFERED_HPP
+#define BUFFERED_HPP
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <span>
+#include <typeinfo>
+#include "component.hpp"
+#include "config.hpp"
+#include "stats.hpp"
+#include "storage.hpp"
+
+namespace ecs {
+    /**
+     * Storage holding a previous and a next value per component, both share one index. Systems read the previous
+     * tick and write the next one, swap_buffers turns next into previous in O(1). The new next buffer still holds
+     * the values of the tick before, so systems should overwrite every component they are responsible for.
+     */
+    template<typename T, typename Config>
+    class buffered_component : public basic_base_component<Config> {
+    public:
+        using config_type = Config;
+        using entity_type = typename Config::entity_type;
+        using layout_type = typename Config::layout_type;
+
+    private:
+        using storage_type = typename Config::template storage_type<T>;
+
+        std::array<storage_type, 2> m_buffers;
+        layout_type m_layout;
+        // Index of the buffer written in the current tick
+        std::size_t m_next{};
+        std::size_t m_adds{};
+        std::size_t m_removes{};
+        std::size_t m_swaps{};
+
+        storage_type &next() noexcept { return m_buffers[m_next]; }
+        storage_type const &prev() const noexcept { return m_buffers[m_next ^ 1]; }
+
+    public:
+        // Sets both values of the component to c
+        error add(entity_type e, T const &c) {
+            auto const new_index = m_layout.add(e);
+            if (!new_index.has_value()) {
+                return new_index.error();
+            }
+            for (auto &buffer: m_buffers) {
+                buffer.reserve(new_index.value() + 1);
+                buffer[new_index.value()] = c;
+            }
+            ++m_adds;
+            return error::ok;
+        }
+
+        error add_bulk(std::span<entity_type const> entities, T const &c) {
+            if (size() + entities.size() > Config::max_entities) {
+                return error::max_entities;
+            }
+            if (std::any_of(entities.begin(), entities.end(), [this](entity_type e) { return m_layout.contains(e); }) ||
+                detail::has_duplicates(entities)) {
+                return error::exists;
+            }
+            auto const first_index = size();
+            if (auto const err = detail::add_all(m_layout, entities); err != error::ok) {
+                return err;
+            }
+            for (auto &buffer: m_buffers) {
+                buffer.reserve(first_index + entities.size());
+                buffer.fill(first_index, entities.size(), c);
+            }
+            m_adds += entities.size();
+            return error::ok;
+        }
+
+        error remove(entity_type e) {
+            auto const removed_entity = m_layout.remove(e);
+            if (!removed_entity.has_value()) {
+                return removed_entity.error();
+            }
+            auto const last_index = m_layout.size();
+            if (auto const removed_index = removed_entity.value(); removed_index != last_index) {
+                for (auto &buffer: m_buffers) {
+                    buffer[removed_index] = buffer[last_index];
+                }
+                ++m_swaps;
+            }
+            ++m_removes;
+            return error::ok;
+        }
+
+        // Access to the next value
+        T &get(entity_type e) {
+            if (auto const index = m_layout.get(e); index.has_value()) {
+                return next()[index.value()];
+            }
+            detail::throw_entity_not_found(e);
+        }
+
+        T get(entity_type e) const {
+            if (auto const index = m_layout.get(e); index.has_value()) {
+                return m_buffers[m_next][index.value()];
+            }
+            detail::throw_entity_not_found(e);
+        }
+
+        T *try_get(entity_type e) noexcept {
+            auto const index = m_layout.get(e);
+            return index.has_value() ? &next()[index.value()] : nullptr;
+        }
+
+        T const *try_get(entity_type e) const noexcept {
+            auto const index = m_layout.get(e);
+            return index.has_value() ? &m_buffers[m_next][index.value()] : nullptr;
+        }
+
+        T &get_unchecked(entity_type e) noexcept {
+            assert(contains(e) && "get_unchecked on an entity without the component");
+            return next()[*m_layout.get(e)];
+        }
+
+        // Access to the previous value
+        T const &get_prev(entity_type e) const {
+            if (auto const index = m_layout.get(e); index.has_value()) {
+                return prev()[index.value()];
+            }
+            detail::throw_entity_not_found(e);
+        }
+
+        T const *try_get_prev(entity_type e) const noexcept {
+            auto const index = m_layout.get(e);
+            return index.has_value() ? &prev()[index.value()] : nullptr;
+        }
+
+        T const &get_prev_unchecked(entity_type e) const noexcept {
+            assert(contains(e) && "get_prev_unchecked on an entity without the component");
+            return prev()[*m_layout.get(e)];
+        }
+
+        // The next values become the previous ones
+        void swap_buffers() noexcept override { m_next ^= 1; }
+
+        error add_erased(entity_type e, void const *value) override {
+            return add(e, value ? *static_cast<T const *>(value) : T{});
+        }
+
+        [[nodiscard]] void *try_get_erased(entity_type e) noexcept override { return try_get(e); }
+
+        error clear() override {
+            for (auto &buffer: m_buffers) {
+                buffer.fill(0, size(), T{});
+            }
+            m_layout.clear();
+            return error::ok;
+        }
+
+        [[nodiscard]] bool contains(entity_type e) const noexcept override { return m_layout.contains(e); }
+
+        error destroy(entity_type e) override { return remove(e); }
+
+        void shrink_to_fit() override {
+            for (auto &buffer: m_buffers) {
+                buffer.shrink(size());
+            }
+            m_layout.shrink_to_fit();
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept { return m_layout.size(); }
+
+        // Owners of the components in storage order, entities()[i] owns the i-th component
+        [[nodiscard]] std::span<entity_type const> entities() const noexcept { return m_layout.dense(); }
+        [[nodiscard]] std::size_t page_count() const noexcept {
+            return (size() + Config::page_size - 1) / Config::page_size;
+        }
+        // Contiguous previous values of a page, the values of the last completed tick
+        [[nodiscard]] std::span<T const> page(std::size_t index) const noexcept {
+            auto const first = index * Config::page_size;
+            return {&prev()[first], std::min(Config::page_size, size() - first)};
+        }
+
+        [[nodiscard]] pool_stats stats() const override {
+            return {
+                    .type_name = typeid(T).name(),
+                    .size = size(),
+                    .capacity = std::min(m_buffers[0].capacity(), m_buffers[1].capacity()),
+                    .bytes_used = 2 * size() * sizeof(T),
+                    .bytes_reserved = (m_buffers[0].capacity() + m_buffers[1].capacity()) * sizeof(T),
+                    .index_bytes = m_layout.index_bytes(),
+                    .adds = m_adds,
+                    .removes = m_removes,
+                    .swaps = m_swaps,
+            };
+        }
+    };
+
+    // Marks a component parameter of each as read-only access to the previous value of a double buffered component
+    template<typename T>
+    struct prev {};
+
+    namespace detail {
+        // How each hands out a component of its parameter list
+        template<typename T>
+        struct access {
+            using component = T;
+            using reference = T &;
+
+            template<typename Pool, typename Entity>
+            static reference get(Pool &pool, Entity e) noexcept {
+                return pool.get_unchecked(e);
+            }
+        };
+
+        template<typename T>
+        struct access<prev<T>> {
+            using component = T;
+            using reference = T const &;
+
+            template<typename Pool, typename Entity>
+            static reference get(Pool &pool, Entity e) noexcept {
+                return pool.get_prev_unchecked(e);
+            }
+        };
+
+        template<typename T>
+        using component_of_t = typename access<T>::component;
+        template<typename T>
+        using reference_of_t = typename access<T>::reference;
+    } // namespace detail
+} // namespace ecs
+#endif // BUFFERED_HPP
@@ -0,0 +1,198 @@
+//
+// Created by HP on 19.10.2026.
+//
+
+#ifndef COLUMNAR_HPP
+#define COLUMNAR_HPP
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+#include <vector>
+#include "pool.hpp"
+#include "type_index.hpp"
+
+namespace ecs {
+    /**
+     * Describes an exported column. Formats follow the Arrow C data interface: arithmetic types map to their
+     * primitive format, e.g. "f" for float, every other trivially copyable type to fixed size binary "w:<size>".
+     */
+    struct column_schema {
+        std::string name{};
+        // Arrow format of the component values
+        std::string format{};
+        // Arrow format of the entity column
+        std::string entity_format{};
+        std::size_t byte_width{};
+        std::size_t alignment{};
+    };
+
+    namespace detail {
+        template<typename T>
+        std::string arrow_format() {
+            if constexpr (std::is_floating_point_v<T> && sizeof(T) == 4) {
+                return "f";
+            } else if constexpr (std::is_floating_point_v<T> && sizeof(T) == 8) {
+                return "g";
+            } else if constexpr (std::is_integral_v<T> && !std::is_same_v<T, bool>) {
+                // Arrow booleans are bit packed, so bool is exported as binary like any other type
+                constexpr char formats[] = {'c', 's', 'i', 'l'};
+                constexpr auto index = sizeof(T) == 1 ? 0 : sizeof(T) == 2 ? 1 : sizeof(T) == 4 ? 2 : 3;
+                auto const format = formats[index];
+                return std::string(1, std::is_signed_v<T> ? format : static_cast<char>(format - 'a' + 'A'));
+            } else {
+                return "w:" + std::to_string(sizeof(T));
+            }
+        }
+    } // namespace detail
+
+    template<typename T, typename Config>
+    column_schema make_schema() {
+        return {
+                .name = typeid(T).name(),
+                .format = detail::arrow_format<T>(),
+                .entity_format = detail::arrow_format<typename Config::entity_type>(),
+                .byte_width = sizeof(T),
+                .alignment = alignof(T),
+        };
+    }
+
+    // Contiguous part of a column, entities[i] owns values[i]
+    template<typename T, typename Entity>
+    struct column_chunk {
+        std::span<Entity const> entities{};
+        std::span<T const> values{};
+    };
+
+    /**
+     * Read-only view of the dense arrays of a pool, one chunk per storage page. Nothing is copied, so the spans
+     * are only valid until the next structural change of the pool. Double buffered pools export their previous
+     * values, which stay unchanged while systems write the next tick.
+     */
+    template<typename T, typename Config>
+    class basic_column {
+    public:
+        using entity_type = typename Config::entity_type;
+        using chunk_type = column_chunk<T, entity_type>;
+        using pool = pool_type<T, Config>;
+
+    private:
+        static_assert(std::is_trivially_copyable_v<T> && !std::is_empty_v<T>,
+                      "only trivially copyable components with values can be exported");
+        static_assert(requires(pool const &p) { p.page(0); }, "the pool of T has no dense value array");
+
+        pool const *m_pool{nullptr};
+
+    public:
+        basic_column() = default;
+        explicit basic_column(pool const *pool) noexcept : m_pool{pool} {}
+
+        [[nodiscard]] static column_schema schema() { return make_schema<T, Config>(); }
+
+        [[nodiscard]] std::size_t size() const noexcept { return m_pool ? m_pool->size() : 0; }
+        [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+        [[nodiscard]] std::size_t chunk_count() const noexcept { return m_pool ? m_pool->page_count() : 0; }
+
+        // The complete entity column, it is contiguous in every storage
+        [[nodiscard]] std::span<entity_type const> entities() const noexcept {
+            return m_pool ? m_pool->entities() : std::span<entity_type const>{};
+        }
+
+        // index has to be less than chunk_count()
+        [[nodiscard]] chunk_type chunk(std::size_t index) const noexcept {
+            auto const values = m_pool->page(index);
+            return {entities().subspan(index * Config::page_size, values.size()), values};
+        }
+
+        // Invokes func(column_chunk) for every chunk in storage order
+        template<typename Func>
+        void each_chunk(Func &&func) const {
+            for (std::size_t i = 0; i < chunk_count(); ++i) {
+                func(chunk(i));
+            }
+        }
+    };
+
+    /**
+     * Owning copy of several columns, taken at one point in time, e.g. between two ticks. It shares nothing with
+     * the world, so other threads may read it while the simulation goes on.
+     */
+    template<typename Config>
+    class basic_snapshot {
+    public:
+        using entity_type = typename Config::entity_type;
+
+    private:
+        struct column_data {
+            type_id_t id{};
+            column_schema schema{};
+            std::vector<entity_type> entities{};
+            // Values are kept typed, so their alignment is correct
+            std::shared_ptr<void const> values{};
+            void const *data{};
+        };
+
+        std::vector<column_data> m_columns{};
+
+        column_data const *find(type_id_t id) const noexcept {
+            auto const found = std::find_if(m_columns.begin(), m_columns.end(),
+                                            [id](column_data const &column) { return column.id == id; });
+            return found == m_columns.end() ? nullptr : &*found;
+        }
+
+    public:
+        // Copies the column, a previous copy of the same component is replaced
+        template<typename T>
+        void add(basic_column<T, Config> const &source) {
+            auto values = std::make_shared<std::vector<T>>();
+            values->reserve(source.size());
+            source.each_chunk([&values](auto const &chunk) {
+                values->insert(values->end(), chunk.values.begin(), chunk.values.end());
+            });
+            column_data data{
+                    .id = type_id<T>(),
+                    .schema = source.schema(),
+                    .entities = {source.entities().begin(), source.entities().end()},
+                    .data = values->data(),
+            };
+            data.values = std::move(values);
+            std::erase_if(m_columns, [&data](column_data const &column) { return column.id == data.id; });
+            m_columns.push_back(std::move(data));
+        }
+
+        [[nodiscard]] std::size_t column_count() const noexcept { return m_columns.size(); }
+
+        template<typename T>
+        [[nodiscard]] bool contains() const noexcept {
+            return find(type_id<T>()) != nullptr;
+        }
+
+        // Empty if T was not copied
+        template<typename T>
+        [[nodiscard]] std::span<T const> values() const noexcept {
+            auto const *column = find(type_id<T>());
+            if (!column) {
+                return {};
+            }
+            return *static_cast<std::vector<T> const *>(column->values.get());
+        }
+
+        template<typename T>
+        [[nodiscard]] std::span<entity_type const> entities() const noexcept {
+            auto const *column = find(type_id<T>());
+            return column ? std::span<entity_type const>{column->entities} : std::span<entity_type const>{};
+        }
+
+        // Untyped access by position, e.g. to hand all columns to an Arrow writer
+        [[nodiscard]] column_schema const &schema(std::size_t index) const { return m_columns.at(index).schema; }
+        [[nodiscard]] std::span<entity_type const> entities(std::size_t index) const {
+            return m_columns.at(index).entities;
+        }
+        // Points to entities(index).size() values of schema(index).byte_width bytes each
+        [[nodiscard]] void const *data(std::size_t index) const { return m_columns.at(index).data; }
+    };
+} // namespace ecs
+#endif // COLUMNAR_HPP
@@ -4,83 +4,371 @@
 
 #ifndef COMPONENT_HPP
 #define COMPONENT_HPP
-#include <array>
+#include <algorithm>
+#include <cassert>
 #include <format>
+#include <span>
 #include <stdexcept>
 #include <tl/expected.hpp>
+#include <type_traits>
+#include <typeinfo>
+#include <vector>
 #include "compressor.hpp"
-#include "const.hpp"
+#include "config.hpp"
+#include "stats.hpp"
+#include "storage.hpp"
 
 namespace ecs {
+    namespace detail {
+        // Kept out of line, so the hot path of get stays small enough to be inlined
+        template<typename Entity>
+        [[noreturn]] void throw_entity_not_found(Entity e) {
+            throw std::out_of_range(std::format("entity {} not found", e));
+        }
+
+        // True if a handle occurs more than once
+        template<typename Entity>
+        bool has_duplicates(std::span<Entity const> entities) {
+            std::vector<Entity> sorted{entities.begin(), entities.end()};
+            std::sort(sorted.begin(), sorted.end());
+            return std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end();
+        }
 
-    class base_component {
+        // Adds all entities to the layout, on failure the entities added so far are removed again
+        template<typename Layout, typename Entity>
+        error add_all(Layout &layout, std::span<Entity const> entities) {
+            for (std::size_t i = 0; i < entities.size(); ++i) {
+                if (auto const new_index = layout.add(entities[i]); !new_index.has_value()) {
+                    // they are the last entries of the layout, so removing them in reverse moves nothing
+                    for (auto j = i; j-- > 0;) {
+                        layout.remove(entities[j]);
+                    }
+                    return new_index.error();
+                }
+            }
+            return error::ok;
+        }
+    } // namespace detail
+
+    template<typename Config>
+    class basic_base_component {
     public:
-        virtual ~base_component() = default;
-        virtual error destroy(entity) = 0;
+        using entity_type = typename Config::entity_type;
+
+        virtual ~basic_base_component() = default;
+        virtual error destroy(entity_type) = 0;
         virtual error clear() = 0;
-        virtual bool contains(entity) = 0;
+        [[nodiscard]] virtual bool contains(entity_type) const noexcept = 0;
+        [[nodiscard]] virtual pool_stats stats() const = 0;
+        // Releases pages and index memory not needed for the current components
+        virtual void shrink_to_fit() = 0;
+
+        // Turns the next values of double buffered components into the previous ones, other pools ignore it
+        virtual void swap_buffers() noexcept {}
+
+        // Type erased access for components addressed by their type id
+        // value points to the component to copy, nullptr default constructs it
+        virtual error add_erased(entity_type, void const *value) = 0;
+        // Returns nullptr if e does not own the component
+        [[nodiscard]] virtual void *try_get_erased(entity_type) noexcept = 0;
     };
 
+    using base_component = basic_base_component<default_config>;
+
     template<typename T, typename MemoryLayout>
-    class component : public base_component {
-        static_assert(std::is_base_of_v<memory_layout::base_layout, MemoryLayout>,
-                      "MemoryLayout must inherit layout interface");
+    class component : public basic_base_component<typename MemoryLayout::config_type> {
+    public:
+        using config_type = typename MemoryLayout::config_type;
+        using entity_type = typename config_type::entity_type;
 
     private:
-        using component_array = std::array<T, ENTITY_COUNT>;
-        component_array m_components;
-        MemoryLayout m_layout;
+        static_assert(std::is_base_of_v<memory_layout::basic_base_layout<config_type>, MemoryLayout>,
+                      "MemoryLayout must inherit layout interface");
 
+        typename config_type::template storage_type<T> m_components;
+        MemoryLayout m_layout;
+        std::size_t m_adds{};
+        std::size_t m_removes{};
+        std::size_t m_swaps{};
 
     public:
-        error add(entity e, T const &c) {
+        error add(entity_type e, T const &c) {
             auto const new_index = m_layout.add(e);
             if (new_index.has_value()) {
+                m_components.reserve(new_index.value() + 1);
                 m_components[new_index.value()] = c;
+                ++m_adds;
                 return error::ok;
             }
             return new_index.error();
         }
 
-        error remove(entity e) {
+        // Adds c for all entities, the values are written as one contiguous block behind the current components
+        error add_bulk(std::span<entity_type const> entities, T const &c) {
+            if (entities.empty()) {
+                return error::ok;
+            }
+            if (size() + entities.size() > config_type::max_entities) {
+                return error::max_entities;
+            }
+            if (std::any_of(entities.begin(), entities.end(), [this](entity_type e) { return m_layout.contains(e); }) ||
+                detail::has_duplicates(entities)) {
+                return error::exists;
+            }
+
+            auto const first_index = size();
+            if (auto const err = detail::add_all(m_layout, entities); err != error::ok) {
+                return err;
+            }
+            m_components.reserve(first_index + entities.size());
+            m_components.fill(first_index, entities.size(), c);
+            m_adds += entities.size();
+            return error::ok;
+        }
+
+        error remove(entity_type e) {
             auto const removed_entity = m_layout.remove(e);
             if (removed_entity.has_value()) {
                 auto const last_index = m_layout.size();
                 auto const removed_entity_index = removed_entity.value();
 
-                m_components[removed_entity_index] = m_components[last_index];
+                if (removed_entity_index != last_index) {
+                    m_components[removed_entity_index] = m_components[last_index];
+                    ++m_swaps;
+                }
+                ++m_removes;
                 return error::ok;
             }
             return removed_entity.error();
         }
 
-        T &get(entity e) {
+        T &get(entity_type e) {
             auto const entity_index = m_layout.get(e);
             if (entity_index.has_value()) {
                 return m_components[entity_index.value()];
             }
-            throw std::out_of_range(std::format("entity {} not found", e));
+            detail::throw_entity_not_found(e);
         }
 
-        T get(entity e) const {
+        T get(entity_type e) const {
             auto const entity_index = m_layout.get(e);
             if (entity_index.has_value()) {
                 return m_components[entity_index.value()];
             }
-            throw std::out_of_range(std::format("entity {} not found", e));
+            detail::throw_entity_not_found(e);
+        }
+
+        // Returns nullptr if e does not own the component
+        T *try_get(entity_type e) noexcept {
+            auto const entity_index = m_layout.get(e);
+            return entity_index.has_value() ? &m_components[entity_index.value()] : nullptr;
+        }
+
+        T const *try_get(entity_type e) const noexcept {
+            auto const entity_index = m_layout.get(e);
+            return entity_index.has_value() ? &m_components[entity_index.value()] : nullptr;
+        }
+
+        // e has to own the component, e.g. because it was found by a view, debug builds assert it
+        T &get_unchecked(entity_type e) noexcept {
+            assert(contains(e) && "get_unchecked on an entity without the component");
+            return m_components[*m_layout.get(e)];
+        }
+
+        error add_erased(entity_type e, void const *value) override {
+            if (value) {
+                return add(e, *static_cast<T const *>(value));
+            }
+            if constexpr (std::is_default_constructible_v<T>) {
+                return add(e, T{});
+            } else {
+                return error::failed;
+            }
         }
 
+        [[nodiscard]] void *try_get_erased(entity_type e) noexcept override { return try_get(e); }
+
         error clear() override {
+            m_components.fill(0, size(), T{});
             m_layout.clear();
-            std::fill(m_components.begin(), m_components.end(), T{});
             return error::ok;
         }
 
-        bool contains(entity e) override { return m_layout.contains(e); }
+        [[nodiscard]] bool contains(entity_type e) const noexcept override { return m_layout.contains(e); }
+
+        error destroy(entity_type e) override { return remove(e); }
+
+        void shrink_to_fit() override {
+            m_components.shrink(size());
+            m_layout.shrink_to_fit();
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept { return m_layout.size(); }
+
+        // Owners of the components in storage order, entities()[i] owns the i-th component
+        [[nodiscard]] std::span<entity_type const> entities() const noexcept { return m_layout.dense(); }
+        [[nodiscard]] std::size_t page_count() const noexcept {
+            return (size() + config_type::page_size - 1) / config_type::page_size;
+        }
+        // Contiguous components of a page, the last page may be partially filled
+        [[nodiscard]] std::span<T const> page(std::size_t index) const noexcept {
+            auto const first = index * config_type::page_size;
+            return {&m_components[first], std::min(config_type::page_size, size() - first)};
+        }
+
+        [[nodiscard]] pool_stats stats() const override {
+            return {
+                    .type_name = typeid(T).name(),
+                    .size = size(),
+                    .capacity = m_components.capacity(),
+                    .bytes_used = size() * sizeof(T),
+                    .bytes_reserved = m_components.capacity() * sizeof(T),
+                    .index_bytes = m_layout.index_bytes(),
+                    .adds = m_adds,
+                    .removes = m_removes,
+                    .swaps = m_swaps,
+            };
+        }
+    };
+
+    /**
+     * Storage for empty component types (tags). Only the membership of an entity is recorded, indexed by the
+     * entity index. Without versions a bitset suffices, otherwise the owning handle is kept to reject stale handles.
+     * There is no value array and no index mapping, all members share a single instance of the tag.
+     */
+    template<typename T, typename MemoryLayout>
+        requires std::is_empty_v<T>
+    class component<T, MemoryLayout> : public basic_base_component<typename MemoryLayout::config_type> {
+    public:
+        using config_type = typename MemoryLayout::config_type;
+        using entity_type = typename config_type::entity_type;
+
+    private:
+        static_assert(std::is_base_of_v<memory_layout::basic_base_layout<config_type>, MemoryLayout>,
+                      "MemoryLayout must inherit layout interface");
+
+        static constexpr bool versioned = config_type::version_bits > 0;
+        using member_type = std::conditional_t<versioned, entity_type, bool>;
+        static constexpr member_type absent = versioned ? member_type(config_type::null) : member_type(false);
+
+        inline static T s_instance{};
+        std::vector<member_type> m_members{};
+        std::size_t m_size{};
+        std::size_t m_adds{};
+        std::size_t m_removes{};
+
+        static member_type member_of(entity_type e) {
+            if constexpr (versioned) {
+                return e;
+            } else {
+                return true;
+            }
+        }
+
+    public:
+        error add(entity_type e, T const &) {
+            if (contains(e)) {
+                return error::exists;
+            }
+            if (m_size >= config_type::max_entities) {
+                return error::max_entities;
+            }
+            auto const index = config_type::to_index(e);
+            if (index >= m_members.size()) {
+                m_members.resize(static_cast<std::size_t>(index) + 1, absent);
+            }
+            m_members[index] = member_of(e);
+            ++m_size;
+            ++m_adds;
+            return error::ok;
+        }
+
+        error add_bulk(std::span<entity_type const> entities, T const &c) {
+            if (m_size + entities.size() > config_type::max_entities) {
+                return error::max_entities;
+            }
+            if (std::any_of(entities.begin(), entities.end(), [this](entity_type e) { return contains(e); }) ||
+                detail::has_duplicates(entities)) {
+                return error::exists;
+            }
+            for (auto const e: entities) {
+                add(e, c);
+            }
+            return error::ok;
+        }
+
+        error remove(entity_type e) {
+            if (!contains(e)) {
+                return error::not_found;
+            }
+            m_members[config_type::to_index(e)] = absent;
+            --m_size;
+            ++m_removes;
+            return error::ok;
+        }
+
+        T &get(entity_type e) {
+            if (contains(e)) {
+                return s_instance;
+            }
+            detail::throw_entity_not_found(e);
+        }
+
+        T get(entity_type e) const {
+            if (contains(e)) {
+                return s_instance;
+            }
+            detail::throw_entity_not_found(e);
+        }
+
+        T *try_get(entity_type e) noexcept { return contains(e) ? &s_instance : nullptr; }
+        T const *try_get(entity_type e) const noexcept { return contains(e) ? &s_instance : nullptr; }
+        T &get_unchecked([[maybe_unused]] entity_type e) noexcept {
+            assert(contains(e) && "get_unchecked on an entity without the component");
+            return s_instance;
+        }
+
+        error add_erased(entity_type e, void const *) override { return add(e, s_instance); }
+        [[nodiscard]] void *try_get_erased(entity_type e) noexcept override { return try_get(e); }
+
+        error clear() override {
+            m_members.clear();
+            m_size = 0;
+            return error::ok;
+        }
 
-        error destroy(entity e) override { return remove(e); }
+        [[nodiscard]] bool contains(entity_type e) const noexcept override {
+            auto const index = config_type::to_index(e);
+            return index < m_members.size() && m_members[index] == member_of(e);
+        }
+
+        error destroy(entity_type e) override { return remove(e); }
+
+        void shrink_to_fit() override {
+            auto const last = std::find_if(m_members.rbegin(), m_members.rend(),
+                                           [](member_type const &member) { return member != absent; });
+            m_members.erase(last.base(), m_members.end());
+            m_members.shrink_to_fit();
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept { return m_size; }
 
-        [[nodiscard]] std::size_t size() const { return m_layout.size(); }
+        [[nodiscard]] pool_stats stats() const override {
+            auto const index_bytes =
+                    versioned ? m_members.capacity() * sizeof(member_type) : m_members.capacity() / 8;
+            return {
+                    .type_name = typeid(T).name(),
+                    .size = size(),
+                    // tags have no values, report the entity indices the membership array covers
+                    .capacity = m_members.capacity(),
+                    .bytes_used = 0,
+                    .bytes_reserved = 0,
+                    .index_bytes = index_bytes,
+                    .adds = m_adds,
+                    .removes = m_removes,
+                    .swaps = 0,
+            };
+        }
     };
 } // namespace ecs
 #endif // COMPONENT_HPP
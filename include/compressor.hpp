@@ -5,43 +5,111 @@
 #ifndef COMPRESSOR_HPP
 #define COMPRESSOR_HPP
 
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <span>
 #include <tl/expected.hpp>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include "config.hpp"
 #include "error.hpp"
 #include "types.hpp"
 
 namespace memory_layout {
-    class base_layout {
+    template<typename Config>
+    class basic_base_layout {
     public:
-        virtual ~base_layout() = default;
+        using config_type = Config;
+        using entity_type = typename Config::entity_type;
+
+        virtual ~basic_base_layout() = default;
 
         // Returns new array index of added entity
-        virtual tl::expected<size_t, ecs::error> add(ecs::entity) = 0;
+        virtual tl::expected<size_t, ecs::error> add(entity_type) = 0;
         // Returns index of given entity
-        [[nodiscard]] virtual tl::expected<size_t, ecs::error> get(ecs::entity) const = 0;
+        [[nodiscard]] virtual tl::expected<size_t, ecs::error> get(entity_type) const noexcept = 0;
         // Returns index of removed entity
-        virtual tl::expected<size_t, ecs::error> remove(ecs::entity) = 0;
+        virtual tl::expected<size_t, ecs::error> remove(entity_type) = 0;
         virtual ecs::error clear() = 0;
         // Current size of entities
-        [[nodiscard]] virtual size_t size() const = 0;
-        [[nodiscard]] virtual bool contains(ecs::entity) const = 0;
+        [[nodiscard]] virtual size_t size() const noexcept = 0;
+        [[nodiscard]] virtual bool contains(entity_type) const noexcept = 0;
+        // Approximate memory used by the index structures in bytes
+        [[nodiscard]] virtual size_t index_bytes() const = 0;
+        // Releases memory of the index structures not needed for the current entities
+        virtual void shrink_to_fit() = 0;
+        // Entities in array index order
+        [[nodiscard]] virtual std::span<entity_type const> dense() const noexcept = 0;
+    };
+
+    template<typename Config>
+    class basic_compressed : public basic_base_layout<Config> {
+    public:
+        using typename basic_base_layout<Config>::entity_type;
+
+    private:
+        std::unordered_map<entity_type, std::size_t> m_entity_to_index{};
+        // Dense, the entity stored at array index i
+        typename Config::template vector_type<entity_type> m_index_to_entity{};
+
+    public:
+        basic_compressed() = default;
+
+        tl::expected<size_t, ecs::error> add(entity_type) override;
+        [[nodiscard]] tl::expected<size_t, ecs::error> get(entity_type) const noexcept override;
+        tl::expected<size_t, ecs::error> remove(entity_type) override;
+        ecs::error clear() override;
+        [[nodiscard]] size_t size() const noexcept override;
+        [[nodiscard]] bool contains(entity_type) const noexcept override;
+        [[nodiscard]] size_t index_bytes() const override;
+        void shrink_to_fit() override;
+        [[nodiscard]] std::span<entity_type const> dense() const noexcept override { return m_index_to_entity; }
     };
 
-    class compressed : public base_layout {
+    /**
+     * Layout with a sparse array indexed by the entity index instead of a hash map. The array lives in the index
+     * storage of the backend, so with mapped_backend it is reserved address space for Config::index_count entries
+     * whose untouched pages cost no memory. Lookups need no hashing, memory grows with the highest entity index
+     * instead of the pool size.
+     */
+    template<typename Config>
+    class basic_sparse : public basic_base_layout<Config> {
+    public:
+        using typename basic_base_layout<Config>::entity_type;
+
     private:
-        std::unordered_map<ecs::entity, std::size_t> m_entity_to_index{};
-        std::unordered_map<std::size_t, ecs::entity> m_index_to_entity{};
-        std::size_t m_entity_count{};
+        // Array index + 1, fresh pages are zeroed, so 0 marks an absent entity
+        using slot_type = std::conditional_t<(Config::max_entities < std::numeric_limits<std::uint32_t>::max()),
+                                             std::uint32_t, std::size_t>;
+
+        typename Config::template index_storage_type<slot_type> m_entity_to_index{};
+        typename Config::template vector_type<entity_type> m_index_to_entity{};
 
     public:
-        compressed() = default;
+        basic_sparse() = default;
 
-        tl::expected<size_t, ecs::error> add(ecs::entity) override;
-        [[nodiscard]] tl::expected<size_t, ecs::error> get(ecs::entity) const override;
-        tl::expected<size_t, ecs::error> remove(ecs::entity) override;
+        tl::expected<size_t, ecs::error> add(entity_type) override;
+        [[nodiscard]] tl::expected<size_t, ecs::error> get(entity_type) const noexcept override;
+        tl::expected<size_t, ecs::error> remove(entity_type) override;
         ecs::error clear() override;
-        [[nodiscard]] size_t size() const override;
-        [[nodiscard]] bool contains(ecs::entity) const override;
+        [[nodiscard]] size_t size() const noexcept override { return m_index_to_entity.size(); }
+        [[nodiscard]] bool contains(entity_type e) const noexcept override { return get(e).has_value(); }
+        [[nodiscard]] size_t index_bytes() const override;
+        void shrink_to_fit() override;
+        [[nodiscard]] std::span<entity_type const> dense() const noexcept override { return m_index_to_entity; }
     };
 
+    using base_layout = basic_base_layout<ecs::default_config>;
+    using compressed = basic_compressed<ecs::default_config>;
+    using sparse = basic_sparse<ecs::default_config>;
 } // namespace memory_layout
+
+#include "compressor.tpp"
+
+namespace memory_layout {
+    extern template class basic_compressed<ecs::default_config>;
+    extern template class basic_sparse<ecs::default_config>;
+}
 #endif // COMPRESSOR_HPP
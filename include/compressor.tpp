@@ -0,0 +1,157 @@
+#ifndef COMPRESSOR_TPP
+#define COMPRESSOR_TPP
+
+namespace memory_layout {
+    namespace detail {
+        // Bucket array plus one singly linked node per element
+        template<typename Map>
+        size_t map_bytes(Map const &map) {
+            return map.bucket_count() * sizeof(void *) + map.size() * (sizeof(typename Map::value_type) + sizeof(void *));
+        }
+    } // namespace detail
+
+    template<typename Config>
+    tl::expected<size_t, ecs::error> basic_compressed<Config>::add(entity_type e) {
+        if (contains(e)) {
+            return tl::unexpected(ecs::error::exists);
+        }
+        if (auto const new_index = m_index_to_entity.size(); new_index < Config::max_entities) {
+            m_entity_to_index[e] = new_index;
+            m_index_to_entity.push_back(e);
+            return new_index;
+        }
+        return tl::unexpected(ecs::error::max_entities);
+    }
+
+    template<typename Config>
+    tl::expected<size_t, ecs::error> basic_compressed<Config>::get(entity_type e) const noexcept {
+        if (auto const it = m_entity_to_index.find(e); it != m_entity_to_index.end()) {
+            return it->second;
+        }
+        return tl::unexpected(ecs::error::not_found);
+    }
+
+    template<typename Config>
+    tl::expected<size_t, ecs::error> basic_compressed<Config>::remove(entity_type e) {
+        if (!contains(e)) {
+            return tl::unexpected(ecs::error::not_found);
+        }
+
+        if (auto const removed_entity = m_entity_to_index.find(e); removed_entity != m_entity_to_index.end()) {
+            auto const index_removed_entity = removed_entity->second;
+            m_entity_to_index.erase(removed_entity);
+
+            auto const last_entity = m_index_to_entity.back();
+            m_index_to_entity.pop_back();
+            if (last_entity != e) {
+                m_entity_to_index[last_entity] = index_removed_entity;
+                m_index_to_entity[index_removed_entity] = last_entity;
+            }
+            return index_removed_entity;
+        }
+        return tl::unexpected(ecs::error::not_found);
+    }
+
+    template<typename Config>
+    ecs::error basic_compressed<Config>::clear() {
+        m_entity_to_index.clear();
+        m_index_to_entity.clear();
+        return ecs::error::ok;
+    }
+
+    template<typename Config>
+    size_t basic_compressed<Config>::size() const noexcept {
+        return m_index_to_entity.size();
+    }
+
+    template<typename Config>
+    bool basic_compressed<Config>::contains(entity_type e) const noexcept {
+        return m_entity_to_index.contains(e);
+    }
+
+    template<typename Config>
+    size_t basic_compressed<Config>::index_bytes() const {
+        return detail::map_bytes(m_entity_to_index) + m_index_to_entity.capacity() * sizeof(entity_type);
+    }
+
+    template<typename Config>
+    void basic_compressed<Config>::shrink_to_fit() {
+        // Rebuilding drops the buckets left over from former peaks, rehash does not shrink with every library
+        std::unordered_map<entity_type, std::size_t>{m_entity_to_index.begin(), m_entity_to_index.end()}.swap(
+                m_entity_to_index);
+        m_index_to_entity.shrink_to_fit();
+    }
+
+    template<typename Config>
+    tl::expected<size_t, ecs::error> basic_sparse<Config>::add(entity_type e) {
+        auto const index = static_cast<std::size_t>(Config::to_index(e));
+        if (index >= Config::index_count) {
+            return tl::unexpected(ecs::error::max_entities);
+        }
+        if (contains(e)) {
+            return tl::unexpected(ecs::error::exists);
+        }
+        if (auto const new_index = m_index_to_entity.size(); new_index < Config::max_entities) {
+            m_entity_to_index.reserve(index + 1);
+            m_entity_to_index[index] = static_cast<slot_type>(new_index + 1);
+            m_index_to_entity.push_back(e);
+            return new_index;
+        }
+        return tl::unexpected(ecs::error::max_entities);
+    }
+
+    template<typename Config>
+    tl::expected<size_t, ecs::error> basic_sparse<Config>::get(entity_type e) const noexcept {
+        auto const index = static_cast<std::size_t>(Config::to_index(e));
+        if (index < m_entity_to_index.capacity()) {
+            // the dense entry rejects stale handles whose index was recycled
+            if (auto const slot = m_entity_to_index[index]; slot != 0 && m_index_to_entity[slot - 1] == e) {
+                return slot - 1;
+            }
+        }
+        return tl::unexpected(ecs::error::not_found);
+    }
+
+    template<typename Config>
+    tl::expected<size_t, ecs::error> basic_sparse<Config>::remove(entity_type e) {
+        auto const removed = get(e);
+        if (!removed.has_value()) {
+            return removed;
+        }
+        m_entity_to_index[Config::to_index(e)] = 0;
+        auto const last_entity = m_index_to_entity.back();
+        m_index_to_entity.pop_back();
+        if (last_entity != e) {
+            m_entity_to_index[Config::to_index(last_entity)] = static_cast<slot_type>(removed.value() + 1);
+            m_index_to_entity[removed.value()] = last_entity;
+        }
+        return removed;
+    }
+
+    template<typename Config>
+    ecs::error basic_sparse<Config>::clear() {
+        for (auto const e: m_index_to_entity) {
+            m_entity_to_index[Config::to_index(e)] = 0;
+        }
+        m_index_to_entity.clear();
+        return ecs::error::ok;
+    }
+
+    template<typename Config>
+    size_t basic_sparse<Config>::index_bytes() const {
+        return m_entity_to_index.capacity() * sizeof(slot_type) + m_index_to_entity.capacity() * sizeof(entity_type);
+    }
+
+    template<typename Config>
+    void basic_sparse<Config>::shrink_to_fit() {
+        std::size_t end{};
+        for (auto const e: m_index_to_entity) {
+            end = std::max<std::size_t>(end, static_cast<std::size_t>(Config::to_index(e)) + 1);
+        }
+        m_entity_to_index.shrink(end);
+        m_index_to_entity.shrink_to_fit();
+    }
+} // namespace memory_layout
+
+
+#endif
@@ -0,0 +1,104 @@
+//
+// Created by HP on 19.10.2026.
+//
+
+#ifndef CONFIG_HPP
+#define CONFIG_HPP
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include "const.hpp"
+#include "storage.hpp"
+#include "types.hpp"
+
+namespace memory_layout {
+    template<typename Config>
+    class basic_compressed;
+} // namespace memory_layout
+
+namespace ecs {
+    /**
+     * Compile time configuration of a world and all its stores.
+     *
+     * @tparam Entity Unsigned integer type of entity handles.
+     * @tparam VersionBits Number of high bits of a handle counting how often its index was recycled, 0 disables
+     *         versions. The remaining low bits hold the index.
+     * @tparam PageSize Number of components a pool allocates at once, has to be a power of two.
+     * @tparam MaxEntities Maximum number of components per pool. With a backend reserving address space also the
+     *         number of entity indices.
+     * @tparam Layout Memory layout of the component pools.
+     * @tparam Backend Provides the storage of component values, runtime component values, the entity store and the
+     *         dense arrays and sparse index of the layouts, paged_backend or mapped_backend. The hash map of the
+     *         compressed layout and the concurrent entity store use the heap.
+     */
+    template<std::unsigned_integral Entity = entity, std::size_t VersionBits = 0, std::size_t PageSize = 1024,
+             std::size_t MaxEntities = ENTITY_COUNT, template<typename> class Layout = memory_layout::basic_compressed,
+             typename Backend = paged_backend>
+    struct basic_config {
+        using entity_type = Entity;
+        using layout_type = Layout<basic_config>;
+        template<typename T>
+        using storage_type = typename Backend::template storage<T, PageSize, MaxEntities>;
+        using raw_storage_type = typename Backend::template raw_storage<PageSize, MaxEntities>;
+        // Contiguous array of at most one element per component, e.g. the dense entities of a layout
+        template<typename T>
+        using vector_type = typename Backend::template vector<T, MaxEntities>;
+        using backend_type = Backend;
+
+        static constexpr std::size_t entity_bits = std::numeric_limits<entity_type>::digits;
+        static constexpr std::size_t version_bits = VersionBits;
+        static constexpr std::size_t index_bits = entity_bits - version_bits;
+        static constexpr std::size_t page_size = PageSize;
+        static constexpr std::size_t max_entities = MaxEntities;
+
+        static constexpr entity_type null = std::numeric_limits<entity_type>::max();
+        static constexpr entity_type index_mask =
+                index_bits == entity_bits ? null : static_cast<entity_type>((entity_type{1} << index_bits) - 1);
+
+        // Number of entity indices handed out and addressed by per-index storages, the last index never is. Backends
+        // reserving address space up front are bounded by MaxEntities, so they do not reserve the whole index range.
+        static constexpr std::size_t index_count = Backend::reserves_address_space
+                                                           ? max_entities
+                                                           : std::min<std::size_t>(index_mask, std::size_t{1} << 32);
+        // Storage with one element per entity index, e.g. the index of a sparse layout
+        template<typename T>
+        using index_storage_type = typename Backend::template storage<T, PageSize, index_count>;
+
+        static_assert(version_bits < entity_bits, "VersionBits leaves no bits for the index");
+        static_assert(page_size > 0 && (page_size & (page_size - 1)) == 0, "PageSize has to be a power of two");
+        static_assert(max_entities > 0 && max_entities <= index_mask, "MaxEntities exceeds the index range");
+
+        static constexpr entity_type to_index(entity_type e) { return static_cast<entity_type>(e & index_mask); }
+
+        static constexpr entity_type to_version(entity_type e) {
+            if constexpr (version_bits == 0) {
+                return 0;
+            } else {
+                return static_cast<entity_type>(e >> index_bits);
+            }
+        }
+
+        static constexpr entity_type make_entity(entity_type index, entity_type version) {
+            if constexpr (version_bits == 0) {
+                return index;
+            } else {
+                return static_cast<entity_type>((version << index_bits) | to_index(index));
+            }
+        }
+
+        // Handle for the next reuse of the index of e, never equals null
+        static constexpr entity_type next_version(entity_type e) {
+            if constexpr (version_bits == 0) {
+                return e;
+            } else {
+                auto const version = static_cast<entity_type>((to_version(e) + 1) & (null >> index_bits));
+                auto const next = make_entity(to_index(e), version);
+                return next == null ? make_entity(to_index(e), 0) : next;
+            }
+        }
+    };
+
+    using default_config = basic_config<>;
+} // namespace ecs
+#endif // CONFIG_HPP
@@ -0,0 +1,92 @@
+//
+// Created by HP on 19.10.2026.
+//
+
+#ifndef CONTEXT_HPP
+#define CONTEXT_HPP
+#include <format>
+#include <memory>
+#include <stdexcept>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+#include "error.hpp"
+#include "type_index.hpp"
+
+namespace ecs {
+    /**
+     * Holds at most one instance per type, e.g. time, configuration or other world wide resources.
+     * Instances are indexed by their type id and live outside of the entity pools.
+     */
+    class context {
+    private:
+        std::vector<std::shared_ptr<void>> m_resources{};
+
+    public:
+        context() = default;
+
+        template<typename T, typename... Args>
+        T &emplace(Args &&...args) {
+            auto const id = type_id<T>();
+            if (id >= m_resources.size()) {
+                m_resources.resize(id + 1);
+            }
+            auto resource = std::make_shared<T>(std::forward<Args>(args)...);
+            auto &ref = *resource;
+            m_resources[id] = std::move(resource);
+            return ref;
+        }
+
+        template<typename T>
+        error erase() {
+            auto const id = type_id<T>();
+            if (id >= m_resources.size() || !m_resources[id]) {
+                return error::not_found;
+            }
+            m_resources[id].reset();
+            return error::ok;
+        }
+
+        template<typename T>
+        [[nodiscard]] T *find() {
+            auto const id = type_id<T>();
+            if (id >= m_resources.size()) {
+                return nullptr;
+            }
+            return static_cast<T *>(m_resources[id].get());
+        }
+
+        template<typename T>
+        [[nodiscard]] T const *find() const {
+            auto const id = type_id<T>();
+            if (id >= m_resources.size()) {
+                return nullptr;
+            }
+            return static_cast<T const *>(m_resources[id].get());
+        }
+
+        template<typename T>
+        [[nodiscard]] T &get() {
+            if (auto *resource = find<T>()) {
+                return *resource;
+            }
+            throw std::out_of_range(std::format("context {} not found", typeid(T).name()));
+        }
+
+        template<typename T>
+        [[nodiscard]] T const &get() const {
+            if (auto const *resource = find<T>()) {
+                return *resource;
+            }
+            throw std::out_of_range(std::format("context {} not found", typeid(T).name()));
+        }
+
+        template<typename T>
+        [[nodiscard]] bool contains() const {
+            return find<T>() != nullptr;
+        }
+
+        void clear() { m_resources.clear(); }
+    };
+} // namespace ecs
+#endif // CONTEXT_HPP
@@ -0,0 +1,93 @@
+//
+// Created by HP on 19.10.2026.
+//
+
+#ifndef CURSOR_HPP
+#define CURSOR_HPP
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "config.hpp"
+#include "query.hpp"
+#include "trace.hpp"
+
+namespace ecs {
+    template<typename Config>
+    class basic_ecs;
+
+    struct step_result {
+        // Entities handed to the callable during the step
+        std::size_t processed{};
+        // The step reached the end of the pass, the next step starts a new one
+        bool finished{};
+    };
+
+    /**
+     * Resumable iteration over a query, spread over several steps with an item or time budget each. A pass visits
+     * every entity matching at its start at most once, entities that stop matching before their turn are skipped.
+     * Entities starting to match during a pass are visited from the next pass on, also if they reuse the handle of an
+     * entity destroyed during the pass. Structural changes between steps are allowed, e.g. one step per frame.
+     */
+    template<typename Config>
+    class basic_cursor {
+    public:
+        using entity_type = typename Config::entity_type;
+        using world_type = basic_ecs<Config>;
+
+    private:
+        basic_query<Config> m_query;
+        world_type *m_ecs;
+        // Snapshot of the matching entities at the start of the pass
+        std::vector<entity_type> m_pass{};
+        // Query epoch at the start of the pass, later matches are left for the next pass
+        std::uint64_t m_epoch{};
+        std::size_t m_position{};
+        bool m_active{false};
+
+        template<typename... Components, typename Func, typename Stop>
+        step_result run(Func &func, Stop &&stop);
+
+    public:
+        basic_cursor(basic_query<Config> query, world_type *ecs) : m_query{std::move(query)}, m_ecs{ecs} {}
+
+        /**
+         * @brief Continues the pass with at most max_items entities.
+         *
+         * @tparam Components The types of the components passed to func, they have to be part of the query.
+         * @param max_items The item budget of the step.
+         * @param func Callable taking either (entity, Components&...) or (Components&...).
+         * @return The number of processed entities and whether the pass finished.
+         */
+        template<typename... Components, typename Func>
+        step_result step(std::size_t max_items, Func &&func);
+
+        /**
+         * @brief Continues the pass until budget is used up. The clock is read after every entity, so a step
+         * overruns its budget by at most one call of func.
+         *
+         * @tparam Components The types of the components passed to func, they have to be part of the query.
+         * @param budget The time budget of the step.
+         * @param func Callable taking either (entity, Components&...) or (Components&...).
+         * @return The number of processed entities and whether the pass finished.
+         */
+        template<typename... Components, typename Rep, typename Period, typename Func>
+        step_result step_for(std::chrono::duration<Rep, Period> budget, Func &&func);
+
+        // Drops the current pass, the next step starts a new one
+        void reset() noexcept {
+            m_pass.clear();
+            m_epoch = 0;
+            m_position = 0;
+            m_active = false;
+        }
+
+        // Entities of the current pass not visited yet, including ones that stopped matching
+        [[nodiscard]] std::size_t remaining() const noexcept { return m_pass.size() - m_position; }
+        [[nodiscard]] bool in_pass() const noexcept { return m_active; }
+    };
+
+    using cursor = basic_cursor<default_config>;
+} // namespace ecs
+#endif // CURSOR_HPP
@@ -0,0 +1,57 @@
+#ifndef CURSOR_TPP
+#define CURSOR_TPP
+
+namespace ecs {
+    template<typename Config>
+    template<typename... Components, typename Func, typename Stop>
+    step_result basic_cursor<Config>::run(Func &func, Stop &&stop) {
+        ECS_TRACE_SCOPE("ecs::cursor::step");
+        if (!m_active) {
+            m_pass.assign(m_query.begin(), m_query.end());
+            m_epoch = m_query.epoch();
+            m_position = 0;
+            m_active = true;
+        }
+
+        step_result result{};
+        auto const pools = std::make_tuple(m_ecs->template get_component_ptr<detail::component_of_t<Components>>()...);
+        while (m_position < m_pass.size() && !stop(result.processed)) {
+            auto const e = m_pass[m_position++];
+            if (!m_query.contains_since(e, m_epoch)) {
+                continue;
+            }
+            std::apply(
+                    [&func, e](auto *...components) {
+                        if constexpr (std::is_invocable_v<Func &, entity_type, detail::reference_of_t<Components>...>) {
+                            func(e, detail::access<Components>::get(*components, e)...);
+                        } else {
+                            func(detail::access<Components>::get(*components, e)...);
+                        }
+                    },
+                    pools);
+            ++result.processed;
+        }
+
+        if (m_position == m_pass.size()) {
+            reset();
+            result.finished = true;
+        }
+        return result;
+    }
+
+    template<typename Config>
+    template<typename... Components, typename Func>
+    step_result basic_cursor<Config>::step(std::size_t max_items, Func &&func) {
+        return run<Components...>(func, [max_items](std::size_t processed) { return processed >= max_items; });
+    }
+
+    template<typename Config>
+    template<typename... Components, typename Rep, typename Period, typename Func>
+    step_result basic_cursor<Config>::step_for(std::chrono::duration<Rep, Period> budget, Func &&func) {
+        auto const deadline = std::chrono::steady_clock::now() + budget;
+        return run<Components...>(func, [deadline](std::size_t) { return std::chrono::steady_clock::now() >= deadline; });
+    }
+} // namespace ecs
+
+
+#endif
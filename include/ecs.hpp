@@ -4,57 +4,227 @@
 
 #ifndef ESC_HPP
 #define ESC_HPP
+#include <algorithm>
+#include <format>
 #include <memory>
+#include <span>
 #include <stdexcept>
-#include <string>
+#include <tl/expected.hpp>
+#include <typeinfo>
+#include <unordered_set>
 #include <utility>
+#include <vector>
+#include "columnar.hpp"
 #include "component.hpp"
+#include "config.hpp"
+#include "context.hpp"
+#include "cursor.hpp"
 #include "entity.hpp"
+#include "hierarchy.hpp"
+#include "mapped.hpp"
+#include "prefab.hpp"
+#include "query.hpp"
+#include "runtime.hpp"
+#include "pool.hpp"
+#include "spatial.hpp"
+#include "stats.hpp"
+#include "trace.hpp"
+#include "type_index.hpp"
 #include "view.hpp"
 
 namespace ecs {
 
-    class ecs {
-        using component_store = std::unordered_map<std::string, std::shared_ptr<base_component>>;
+    template<typename Config>
+    class basic_ecs {
+    public:
+        using config_type = Config;
+        using entity_type = typename Config::entity_type;
+        template<typename T>
+        using component_type = pool_type<T, Config>;
 
     private:
-        entity_store m_entities;
+        // Pools indexed by the type id of their component
+        using component_store = std::vector<std::shared_ptr<basic_base_component<Config>>>;
+
+        using query_storage = basic_query_storage<Config>;
+
+        friend class basic_view<Config>;
+        friend class basic_query<Config>;
+        friend class basic_cursor<Config>;
+
+        basic_entity_store<Config> m_entities;
         component_store m_components;
+        context m_context;
+        basic_hierarchy<Config> m_hierarchy;
+        // Queries with at least one handle, the handles own the storages and unregister them when the last one goes
+        std::vector<query_storage *> m_queries;
+        // Queries to refresh when a component changes, indexed by the type id of the component
+        std::vector<std::vector<query_storage *>> m_observers;
+        // Pools of double buffered components
+        std::vector<basic_base_component<Config> *> m_buffered;
+        // Spatial indices indexed by the type id of their position component
+        std::vector<std::shared_ptr<basic_base_spatial_index<Config>>> m_spatial_indices;
+        // Expires first when the ecs is destroyed, query handles outliving it skip unregistering
+        std::shared_ptr<char> m_lifetime{std::make_shared<char>()};
+
+        void release_query(query_storage const *storage) {
+            std::erase(m_queries, storage);
+            for (auto &observers: m_observers) {
+                std::erase(observers, storage);
+            }
+        }
 
+        // Returns nullptr if no component of type T was added yet
         template<typename T>
-        std::shared_ptr<component<T, memory_layout::compressed>> get_component_ptr() {
-            auto const type = typeid(T).name();
-            return std::static_pointer_cast<component<T, memory_layout::compressed>>(m_components.at(type));
+        component_type<T> *get_component_ptr() noexcept {
+            auto const id = type_id<T>();
+            if (id >= m_components.size()) {
+                return nullptr;
+            }
+            return static_cast<component_type<T> *>(m_components[id].get());
         }
 
         template<typename T>
-        void create_component() {
-            auto const type_id = typeid(T).name();
-            if (!m_components.contains(type_id)) {
-                m_components[type_id] = std::make_shared<component<T, memory_layout::compressed>>();
+        component_type<T> const *get_component_ptr() const noexcept {
+            auto const id = type_id<T>();
+            if (id >= m_components.size()) {
+                return nullptr;
             }
+            return static_cast<component_type<T> const *>(m_components[id].get());
         }
 
         template<typename T>
-        error emplace_component(entity e) {
+        component_type<T> &create_component() {
+            auto const id = type_id<T>();
+            if (id >= m_components.size()) {
+                m_components.resize(id + 1);
+            }
+            if (!m_components[id]) {
+                m_components[id] = std::make_shared<component_type<T>>();
+                if constexpr (detail::double_buffered<T>()) {
+                    m_buffered.push_back(m_components[id].get());
+                }
+            }
+            return static_cast<component_type<T> &>(*m_components[id]);
+        }
+
+        template<typename T>
+        [[noreturn]] static void throw_missing_component() {
+            throw std::out_of_range(std::format("component {} not found", typeid(T).name()));
+        }
+
+        template<typename T>
+        error emplace_component(entity_type e) {
             static_assert(std::is_default_constructible_v<T>, "component has to be default constructable");
-            create_component<T>();
-            try {
-                return get_component_ptr<T>()->add(e, T{});
-            } catch (std::out_of_range const &) {
-                return error::failed;
+            return insert<T>(e, T{});
+        }
+
+        [[nodiscard]] bool contains_id(type_id_t id, entity_type e) const noexcept {
+            return id < m_components.size() && m_components[id] && m_components[id]->contains(e);
+        }
+
+        [[nodiscard]] bool matches(query_storage const &storage, entity_type e) const noexcept {
+            auto const owns = [this, e](type_id_t id) { return contains_id(id, e); };
+            return std::all_of(storage.include().begin(), storage.include().end(), owns) &&
+                   std::none_of(storage.exclude().begin(), storage.exclude().end(), owns);
+        }
+
+        // Brings all queries and the spatial index observing the component with the given id up to date for e
+        void notify(type_id_t id, entity_type e) {
+            if (id < m_spatial_indices.size() && m_spatial_indices[id]) {
+                m_spatial_indices[id]->refresh(e, *m_components[id]);
+            }
+            if (id >= m_observers.size()) {
+                return;
+            }
+            for (auto *storage: m_observers[id]) {
+                if (matches(*storage, e)) {
+                    storage->insert(e);
+                } else {
+                    storage->remove(e);
+                }
+            }
+        }
+
+        void forget(entity_type e) {
+            for (auto const &storage: m_queries) {
+                storage->remove(e);
+            }
+            for (auto const &index: m_spatial_indices) {
+                if (index) {
+                    index->remove(e);
+                }
+            }
+        }
+
+        template<typename... Components, typename... Excluded, typename Range>
+        basic_view<Config> make_view(Range const &candidates, exclude_t<Excluded...>) {
+            std::unordered_set<entity_type> e;
+            for (auto const entity: candidates) {
+                bool const ok = all_of<Components...>(entity) && (!contains<Excluded>(entity) && ...);
+                if (ok) {
+                    e.emplace(entity);
+                }
+            }
+
+            auto view = basic_view<Config>::create_view(e, this);
+            if (view.has_value()) {
+                return std::move(view.value());
+            }
+            throw std::invalid_argument("could not create view, invalid ecs");
+        }
+
+        error destroy_components(entity_type e) {
+            auto err = error::ok;
+            for (auto const &components: m_components) {
+                if (!components || !components->contains(e)) {
+                    continue;
+                }
+                if (auto const destroyed = components->destroy(e); destroyed != error::ok) {
+                    err = destroyed;
+                }
             }
+            return err;
         }
 
     public:
-        ecs() = default;
+        basic_ecs() = default;
+        explicit basic_ecs(recycle_policy policy) : m_entities{policy} {}
+        // Views, queries and cursors keep a pointer to their ecs, so it can be neither copied nor moved
+        basic_ecs(basic_ecs const &) = delete;
+        basic_ecs &operator=(basic_ecs const &) = delete;
 
         /**
          * @brief Creates a new entity in the ECS system.
          *
-         * @return The newly created entity.
+         * @return The newly created entity or Config::null if all entity indices are in use.
+         */
+        [[nodiscard]] entity_type create() { return m_entities.create(); }
+
+        /**
+         * @brief Reserves an entity handle. Unlike create it may be called from many threads at once, also while one
+         * other thread keeps using the ecs. The handle becomes a living entity at the next flush, components should
+         * only be added afterward, e.g. by replaying commands the worker threads recorded.
+         *
+         * @return The reserved entity or Config::null if all entity indices are in use.
          */
-        [[nodiscard]] entity create();
+        [[nodiscard]] entity_type reserve() { return m_entities.reserve(); }
+
+        /**
+         * @brief Turns all reserved handles into living entities. Has to be called at a sync point, when no thread
+         * reserves.
+         *
+         * @return The number of adopted entities.
+         */
+        std::size_t flush() { return m_entities.flush(); }
+
+        /**
+         * @brief Checks whether an entity was created and not destroyed yet.
+         *
+         * @param e The entity to check.
+         * @return True if e is living, reserved handles are living after the next flush.
+         */
+        [[nodiscard]] bool alive(entity_type e) const { return m_entities.contains(e); }
 
         /**
          * @brief Destroys an entity and its associated components.
@@ -64,15 +234,41 @@ namespace ecs {
          *         Success: error::ok
          *         Else:    error::not_found or error::failed
          */
-        error destroy(entity e) {
-            auto err = error::ok;
-            if (err = m_entities.destroy(e); err != error::ok) {
+        error destroy(entity_type e) {
+            ECS_TRACE_SCOPE("ecs::destroy");
+            if (auto const err = m_entities.destroy(e); err != error::ok) {
                 return err;
             }
+            m_hierarchy.remove(e);
+            forget(e);
+            return destroy_components(e);
+        }
+
+        /**
+         * @brief Destroys an entity together with all its descendants in the hierarchy.
+         *
+         * @param root The root of the subtree to be destroyed.
+         * @return An error indicating the result of the operation.
+         *         Success: error::ok
+         *         Else:    error::not_found or error::failed
+         */
+        error destroy_subtree(entity_type root) {
+            ECS_TRACE_SCOPE("ecs::destroy_subtree");
+            auto const subtree = m_hierarchy.subtree(root);
+            if (subtree.empty()) {
+                return destroy(root);
+            }
+            m_hierarchy.remove_subtree(root);
 
-            for (auto [key, array]: m_components) {
-                if (err = array->destroy(e); err != error::ok) {
-                    return err;
+            auto err = error::ok;
+            for (auto const e: subtree) {
+                if (auto const destroyed = m_entities.destroy(e); destroyed != error::ok) {
+                    err = destroyed;
+                    continue;
+                }
+                forget(e);
+                if (auto const destroyed = destroy_components(e); destroyed != error::ok) {
+                    err = destroyed;
                 }
             }
             return err;
@@ -86,13 +282,58 @@ namespace ecs {
          *         Else:    error::failed
          */
         error clear() {
+            ECS_TRACE_SCOPE("ecs::clear");
             m_entities.clear();
-            for (auto [key, components]: m_components) {
-                components->clear();
+            m_hierarchy.clear();
+            for (auto const &components: m_components) {
+                if (components) {
+                    components->clear();
+                }
+            }
+            for (auto const &storage: m_queries) {
+                storage->clear();
+            }
+            for (auto const &index: m_spatial_indices) {
+                if (index) {
+                    index->clear();
+                }
             }
             return error::ok;
         }
 
+        /**
+         * @brief Releases memory left over from former peaks: unused component pages, oversized index maps and
+         * free lists. References to components stay valid, iterators of views and queries are invalidated.
+         */
+        void compact() {
+            ECS_TRACE_SCOPE("ecs::compact");
+            m_entities.shrink_to_fit();
+            m_hierarchy.shrink_to_fit();
+            for (auto const &components: m_components) {
+                if (components) {
+                    components->shrink_to_fit();
+                }
+            }
+            for (auto const &storage: m_queries) {
+                storage->shrink_to_fit();
+            }
+            for (auto const &index: m_spatial_indices) {
+                if (index) {
+                    index->shrink_to_fit();
+                }
+            }
+        }
+
+        /**
+         * @brief Selects the order in which indices of destroyed entities are reused. recycle_policy::lifo and
+         * recycle_policy::lowest_index keep the living indices dense and their memory cache-warm. Stale handles are
+         * only rejected if Config has version bits, otherwise they refer to whichever entity reuses their index, and
+         * lifo and lowest_index reuse it sooner than fifo.
+         *
+         * @param policy The recycling policy, recycle_policy::fifo by default.
+         */
+        void set_recycle_policy(recycle_policy policy) { m_entities.set_policy(policy); }
+
         /**
          * @brief Emplaces multiple default-constructible components to an entity.
          *
@@ -103,7 +344,7 @@ namespace ecs {
          *         Else:    error::failed
          */
         template<typename... Components>
-        error emplace(entity e) {
+        error emplace(entity_type e) {
             static_assert((std::is_default_constructible_v<Components> && ...),
                           "components has to be default constructable");
             bool const all_ok = ((emplace_component<Components>(e) == error::ok) && ...);
@@ -125,13 +366,102 @@ namespace ecs {
          *         Else:    error::not_found or error::exists or error::max_entities
          */
         template<typename T>
-        error insert(entity e, T const &component) {
-            create_component<T>();
-            try {
-                return get_component_ptr<T>()->add(e, component);
-            } catch (std::out_of_range const &) {
-                return error::not_found;
+        error insert(entity_type e, T const &component) {
+            auto const err = create_component<T>().add(e, component);
+            if (err == error::ok) {
+                notify(type_id<T>(), e);
+            }
+            return err;
+        }
+
+        /**
+         * @brief Inserts the same component for many entities, the values are written in one contiguous block.
+         *
+         * @tparam T The type of the component to insert.
+         * @param entities The entities to which the component will be added.
+         * @param component The component to be added.
+         * @return An error indicating the result of the operation.
+         *         Success: error::ok
+         *         Else:    error::exists or error::max_entities, no component is added in this case
+         */
+        template<typename T>
+        error insert_bulk(std::span<entity_type const> entities, T const &component) {
+            auto const err = create_component<T>().add_bulk(entities, component);
+            if (err == error::ok) {
+                for (auto const e: entities) {
+                    notify(type_id<T>(), e);
+                }
+            }
+            return err;
+        }
+
+        /**
+         * @brief Captures the specified components of an entity as prefab.
+         *
+         * @tparam Components The types of the components to capture.
+         * @param e The entity owning the components.
+         * @return The prefab or error::not_found if the entity misses one of the components.
+         */
+        template<typename... Components>
+        [[nodiscard]] tl::expected<basic_prefab<Config>, error> make_prefab(entity_type e) const {
+            if (!all_of<Components...>(e)) {
+                return tl::unexpected(error::not_found);
+            }
+            basic_prefab<Config> result;
+            (result.template set<Components>(get<Components>(e)), ...);
+            return result;
+        }
+
+        /**
+         * @brief Creates n entities owning the components of the prefab. Every component pool is filled with one
+         * bulk write.
+         *
+         * @param prefab The prototype of the entities.
+         * @param n The number of entities to create.
+         * @return The created entities or an error, in which case no entity is created. error::max_entities if the
+         *         entity handles or the component pools run out.
+         */
+        [[nodiscard]] tl::expected<std::vector<entity_type>, error> instantiate(basic_prefab<Config> const &prefab, std::size_t n) {
+            std::vector<entity_type> entities;
+            entities.reserve(n);
+            for (std::size_t i = 0; i < n; ++i) {
+                auto const e = m_entities.create();
+                if (e == Config::null) {
+                    for (auto const created: entities) {
+                        m_entities.destroy(created);
+                    }
+                    return tl::unexpected(error::max_entities);
+                }
+                entities.push_back(e);
             }
+            if (auto const err = prefab.apply(*this, entities); err != error::ok) {
+                for (auto const e: entities) {
+                    destroy(e);
+                }
+                return tl::unexpected(err);
+            }
+            return entities;
+        }
+
+        /**
+         * @brief Creates n entities owning the components of the prefab and invokes func for every instance
+         * afterward, e.g. to override single components.
+         *
+         * @param prefab The prototype of the entities.
+         * @param n The number of entities to create.
+         * @param func Callable taking (entity, std::size_t instance_index).
+         * @return The created entities or an error, in which case no entity is created.
+         */
+        template<typename Func>
+        [[nodiscard]] tl::expected<std::vector<entity_type>, error> instantiate(basic_prefab<Config> const &prefab, std::size_t n,
+                                                                           Func &&func) {
+            auto entities = instantiate(prefab, n);
+            if (entities.has_value()) {
+                for (std::size_t i = 0; i < entities->size(); ++i) {
+                    func((*entities)[i], i);
+                }
+            }
+            return entities;
         }
 
         /**
@@ -142,12 +472,9 @@ namespace ecs {
          * @return true if the entity contains the component, false otherwise.
          */
         template<typename T>
-        [[nodiscard]] bool contains(entity e) const {
-            auto const type = typeid(T).name();
-            if (!m_components.contains(type)) {
-                return false;
-            }
-            return m_components.at(type)->contains(e);
+        [[nodiscard]] bool contains(entity_type e) const noexcept {
+            auto const *components = get_component_ptr<T>();
+            return components && components->contains(e);
         }
 
         /**
@@ -158,13 +485,8 @@ namespace ecs {
          * @return true if the entity contains all specified components, false otherwise.
          */
         template<typename... Components>
-        [[nodiscard]] bool all_of(entity e) const {
-            try {
-                bool const ok = ((contains<Components>(e)) && ...);
-                return ok;
-            } catch (std::out_of_range const &) {
-                return false;
-            }
+        [[nodiscard]] bool all_of(entity_type e) const noexcept {
+            return ((contains<Components>(e)) && ...);
         }
 
         /**
@@ -175,13 +497,8 @@ namespace ecs {
          * @return true if the entity contains any of the specified components, false otherwise.
          */
         template<typename... Components>
-        [[nodiscard]] bool any_of(entity e) const {
-            try {
-                bool const ok = ((contains<Components>(e)) || ...);
-                return ok;
-            } catch (std::out_of_range const &) {
-                return false;
-            }
+        [[nodiscard]] bool any_of(entity_type e) const noexcept {
+            return ((contains<Components>(e)) || ...);
         }
 
         /**
@@ -194,8 +511,16 @@ namespace ecs {
          *         Else:    error::not_found
          */
         template<typename T>
-        error erase(entity e) {
-            return get_component_ptr<T>()->remove(e);
+        error erase(entity_type e) {
+            auto *components = get_component_ptr<T>();
+            if (!components) {
+                return error::not_found;
+            }
+            auto const err = components->remove(e);
+            if (err == error::ok) {
+                notify(type_id<T>(), e);
+            }
+            return err;
         }
 
         /**
@@ -207,8 +532,12 @@ namespace ecs {
          * @throws If the entity is not present an std::out_of_range exception is thrown
          */
         template<typename T>
-        T &get(entity e) {
-            return get_component_ptr<T>()->get(e);
+        T &get(entity_type e) {
+            auto *components = get_component_ptr<T>();
+            if (!components) {
+                throw_missing_component<T>();
+            }
+            return components->get(e);
         }
 
         /**
@@ -220,8 +549,66 @@ namespace ecs {
          * @throws If the entity is not present an std::out_of_range exception is thrown
          */
         template<typename T>
-        T get(entity e) const {
-            return get_component_ptr<T>()->get(e);
+        T get(entity_type e) const {
+            auto const *components = get_component_ptr<T>();
+            if (!components) {
+                throw_missing_component<T>();
+            }
+            return components->get(e);
+        }
+
+        /**
+         * @brief Retrieves a pointer to a component of the specified type owned by an entity, without throwing.
+         *
+         * @tparam T The type of the component to retrieve.
+         * @param entity The entity from which the component will be retrieved.
+         * @return A pointer to the component or nullptr if the entity does not own one.
+         */
+        template<typename T>
+        [[nodiscard]] T *try_get(entity_type e) noexcept {
+            auto *components = get_component_ptr<T>();
+            return components ? components->try_get(e) : nullptr;
+        }
+
+        /**
+         * @brief Retrieves a pointer to a component of the specified type owned by an entity, without throwing.
+         *
+         * @tparam T The type of the component to retrieve.
+         * @param entity The entity from which the component will be retrieved.
+         * @return A pointer to the component or nullptr if the entity does not own one.
+         */
+        template<typename T>
+        [[nodiscard]] T const *try_get(entity_type e) const noexcept {
+            auto const *components = get_component_ptr<T>();
+            return components ? components->try_get(e) : nullptr;
+        }
+
+        /**
+         * @brief Retrieves the previous value of a double buffered component, get accesses the next value.
+         *
+         * @tparam T The type of the component to retrieve.
+         * @param e The entity owning the component.
+         * @return A const reference to the previous value.
+         * @throws If the entity is not present an std::out_of_range exception is thrown
+         */
+        template<typename T>
+        T const &get_prev(entity_type e) const {
+            static_assert(detail::double_buffered<T>(), "component is not double buffered");
+            auto const *components = get_component_ptr<T>();
+            if (!components) {
+                throw_missing_component<T>();
+            }
+            return components->get_prev(e);
+        }
+
+        /**
+         * @brief Makes the next values of all double buffered components the previous ones, in O(1) per component
+         * type. Call it once per tick after all systems ran.
+         */
+        void swap_buffers() noexcept {
+            for (auto *components: m_buffered) {
+                components->swap_buffers();
+            }
         }
 
         /**
@@ -233,7 +620,7 @@ namespace ecs {
          * @throws If one component for the entity is not present an std::out_of_range exception is thrown
          */
         template<typename... Components>
-        std::tuple<Components &...> get_multiple(entity e) {
+        std::tuple<Components &...> get_multiple(entity_type e) {
             return {get<Components>(e)...};
         }
 
@@ -246,7 +633,7 @@ namespace ecs {
          * @throws If one component for the entity is not present an std::out_of_range exception is thrown
          */
         template<typename... Components>
-        std::tuple<Components...> get_multiple(entity e) const {
+        std::tuple<Components...> get_multiple(entity_type e) const {
             return {get<Components>(e)...};
         }
 
@@ -254,29 +641,478 @@ namespace ecs {
          * @brief Retrieves a view of all entities that contain the specified components.
          *
          * @tparam Components The types of the components to filter by.
+         * @tparam Excluded The types of the components an entity must not own.
+         * @param exclude Optional list of excluded components, e.g. ecs::exclude<dirty>.
          * @return A view containing all entities that have the specified components.
          * @throws std::invalid_argument if the view cannot be created.
          */
-        template<typename... Components>
-        [[nodiscard]] view view() {
-            std::unordered_set<entity> e;
+        template<typename... Components, typename... Excluded>
+        [[nodiscard]] basic_view<Config> view(exclude_t<Excluded...> excluded = exclude_t<Excluded...>{}) {
+            ECS_TRACE_SCOPE("ecs::view");
+            return make_view<Components...>(m_entities, excluded);
+        }
+
+        /**
+         * @brief Retrieves a view of the candidate entities that contain the specified components, e.g. the result
+         * of a spatial query.
+         *
+         * @tparam Components The types of the components to filter by.
+         * @tparam Excluded The types of the components an entity must not own.
+         * @param candidates The entities to filter.
+         * @param exclude Optional list of excluded components, e.g. ecs::exclude<dirty>.
+         * @return A view containing the candidates that have the specified components.
+         * @throws std::invalid_argument if the view cannot be created.
+         */
+        template<typename... Components, typename... Excluded>
+        [[nodiscard]] basic_view<Config> view(std::span<entity_type const> candidates,
+                                              exclude_t<Excluded...> excluded = exclude_t<Excluded...>{}) {
+            ECS_TRACE_SCOPE("ecs::view");
+            return make_view<Components...>(candidates, excluded);
+        }
+
+        /**
+         * @brief Registers a component type defined at runtime. Its values are stored as raw bytes and are
+         * addressed by the returned id, which shares the id space of static component types.
+         *
+         * @param descriptor Size, alignment and lifetime functions of the component.
+         * @return The id of the component.
+         * @throws std::invalid_argument if the alignment of the descriptor is not a power of two.
+         */
+        type_id_t register_component(component_descriptor descriptor) {
+            auto pool = std::make_shared<runtime_component<typename Config::layout_type>>(std::move(descriptor));
+            auto const id = detail::next_type_id();
+            if (id >= m_components.size()) {
+                m_components.resize(id + 1);
+            }
+            m_components[id] = std::move(pool);
+            return id;
+        }
 
-            for (auto const entity: m_entities) {
-                bool const ok = all_of<Components...>(entity);
+        /**
+         * @brief Inserts a component addressed by its type id, e.g. one registered at runtime.
+         *
+         * @param id The type id of the component.
+         * @param e The entity to which the component will be added.
+         * @param value Pointer to the value to copy, nullptr default constructs the component.
+         * @return An error indicating the result of the operation.
+         *         Success: error::ok
+         *         Else:    error::not_found if no pool has the id, error::exists or error::max_entities,
+         *                  error::failed if value is nullptr and the component has no default
+         */
+        error insert(type_id_t id, entity_type e, void const *value) {
+            if (id >= m_components.size() || !m_components[id]) {
+                return error::not_found;
+            }
+            auto const err = m_components[id]->add_erased(e, value);
+            if (err == error::ok) {
+                notify(id, e);
+            }
+            return err;
+        }
+
+        /**
+         * @brief Removes a component addressed by its type id.
+         *
+         * @param id The type id of the component.
+         * @param e The entity from which the component will be removed.
+         * @return An error indicating the result of the operation.
+         *         Success: error::ok
+         *         Else:    error::not_found
+         */
+        error erase(type_id_t id, entity_type e) {
+            if (id >= m_components.size() || !m_components[id]) {
+                return error::not_found;
+            }
+            auto const err = m_components[id]->destroy(e);
+            if (err == error::ok) {
+                notify(id, e);
+            }
+            return err;
+        }
+
+        /**
+         * @brief Checks if an entity owns the component with the given type id.
+         */
+        [[nodiscard]] bool contains(type_id_t id, entity_type e) const noexcept { return contains_id(id, e); }
+
+        /**
+         * @brief Retrieves a pointer to a component addressed by its type id.
+         *
+         * @param id The type id of the component.
+         * @param e The entity owning the component.
+         * @return A pointer to the component or nullptr if the entity does not own one.
+         */
+        [[nodiscard]] void *try_get(type_id_t id, entity_type e) noexcept {
+            return contains_id(id, e) ? m_components[id]->try_get_erased(e) : nullptr;
+        }
+
+        /**
+         * @brief Retrieves a view of all entities owning the components with the included ids and none with
+         * the excluded ids. Static ids from type_id<T>() and runtime registered ids can be mixed.
+         *
+         * @param include The type ids of the components to filter by, in the order they are handed out.
+         * @param exclude The type ids of the components an entity must not own.
+         * @return A view containing all entities that have the specified components.
+         */
+        [[nodiscard]] basic_runtime_view<Config> runtime_view(std::span<type_id_t const> include,
+                                                              std::span<type_id_t const> exclude = {}) {
+            ECS_TRACE_SCOPE("ecs::runtime_view");
+            std::vector<basic_base_component<Config> *> pools;
+            std::vector<entity_type> entities;
+            for (auto const id: include) {
+                if (id >= m_components.size() || !m_components[id]) {
+                    return {{}, {}, {}};
+                }
+                pools.push_back(m_components[id].get());
+            }
+            for (auto const e: m_entities) {
+                bool const ok = std::all_of(pools.begin(), pools.end(), [e](auto *pool) { return pool->contains(e); }) &&
+                                std::none_of(exclude.begin(), exclude.end(),
+                                             [this, e](type_id_t id) { return contains_id(id, e); });
                 if (ok) {
-                    e.emplace(entity);
+                    entities.push_back(e);
                 }
             }
+            return {std::move(entities), {include.begin(), include.end()}, std::move(pools)};
+        }
 
-            auto view = view::create_view(e, this);
-            if (view.has_value()) {
-                return std::move(view.value());
+        /**
+         * @brief Retrieves a persistent query of all entities that contain the specified components. Unlike a view
+         * the matching entities are kept up to date by every structural change, so iterating costs O(matches).
+         * Queries with the same components share their storage. It stays registered while a handle to it exists,
+         * destroying the last handle unregisters it, so keep the handle instead of retrieving it every frame.
+         *
+         * @tparam Components The types of the components to filter by.
+         * @tparam Excluded The types of the components an entity must not own.
+         * @param exclude Optional list of excluded components, e.g. ecs::exclude<dirty>.
+         * @return A handle to the query.
+         */
+        template<typename... Components, typename... Excluded>
+        [[nodiscard]] basic_query<Config> query(exclude_t<Excluded...> = exclude_t<Excluded...>{}) {
+            static_assert(sizeof...(Components) > 0, "a query needs at least one component");
+            std::vector<type_id_t> include{type_id<Components>()...};
+            std::vector<type_id_t> exclude{type_id<Excluded>()...};
+            std::sort(include.begin(), include.end());
+            std::sort(exclude.begin(), exclude.end());
+
+            for (auto *storage: m_queries) {
+                if (storage->include() == include && storage->exclude() == exclude) {
+                    return basic_query<Config>{storage->shared_from_this(), this};
+                }
             }
-            throw std::invalid_argument("could not create view, invalid ecs");
+
+            ECS_TRACE_SCOPE("ecs::query");
+            auto const release = [this, lifetime = std::weak_ptr<char>{m_lifetime}](query_storage *storage) {
+                if (!lifetime.expired()) {
+                    release_query(storage);
+                }
+                delete storage;
+            };
+            std::shared_ptr<query_storage> storage{new query_storage{std::move(include), std::move(exclude)}, release};
+            for (auto const e: m_entities) {
+                if (matches(*storage, e)) {
+                    storage->insert(e);
+                }
+            }
+            auto const observe = [this, &storage](type_id_t id) {
+                if (id >= m_observers.size()) {
+                    m_observers.resize(id + 1);
+                }
+                m_observers[id].push_back(storage.get());
+            };
+            std::for_each(storage->include().begin(), storage->include().end(), observe);
+            std::for_each(storage->exclude().begin(), storage->exclude().end(), observe);
+            m_queries.push_back(storage.get());
+            return basic_query<Config>{std::move(storage), this};
+        }
+
+        /**
+         * @brief Modifies the component of an entity in place and refreshes the spatial index of its type.
+         * Positions changed through get are not seen by the index.
+         *
+         * @tparam T The type of the component to modify.
+         * @param e The entity owning the component.
+         * @param func Callable taking T&.
+         * @return An error indicating the result of the operation.
+         *         Success: error::ok
+         *         Else:    error::not_found
+         */
+        template<typename T, typename Func>
+        error patch(entity_type e, Func &&func) {
+            auto *component = try_get<T>(e);
+            if (!component) {
+                return error::not_found;
+            }
+            func(*component);
+            notify(type_id<T>(), e);
+            return error::ok;
+        }
+
+        /**
+         * @brief Creates a spatial index over the component T, replacing a previous index of T. All current owners
+         * of T are indexed, afterward the index follows insert, erase, patch and destroy.
+         *
+         * @tparam T The type of the position component.
+         * @param cell_size The edge length of a grid cell, ideally close to the typical query radius.
+         * @param position Callable returning the ecs::point of a T const&.
+         * @return A reference to the index.
+         * @throws std::invalid_argument if cell_size is not positive.
+         */
+        template<typename T, typename Position>
+        basic_spatial_index<Config, T> &make_spatial_index(float cell_size, Position &&position) {
+            auto index = std::make_shared<basic_spatial_index<Config, T>>(cell_size, std::forward<Position>(position));
+            if (auto const *components = get_component_ptr<T>()) {
+                for (auto const e: m_entities) {
+                    index->refresh(e, *components);
+                }
+            }
+            auto const id = type_id<T>();
+            if (id >= m_spatial_indices.size()) {
+                m_spatial_indices.resize(id + 1);
+            }
+            m_spatial_indices[id] = index;
+            return *index;
+        }
+
+        /**
+         * @brief Retrieves the spatial index over the component T.
+         *
+         * @tparam T The type of the position component.
+         * @return A pointer to the index or nullptr if none was made.
+         */
+        template<typename T>
+        [[nodiscard]] basic_spatial_index<Config, T> const *spatial_index() const noexcept {
+            auto const id = type_id<T>();
+            if (id >= m_spatial_indices.size()) {
+                return nullptr;
+            }
+            return static_cast<basic_spatial_index<Config, T> const *>(m_spatial_indices[id].get());
+        }
+
+        /**
+         * @brief Retrieves a cursor which iterates the entities with the specified components over several steps,
+         * e.g. a few per frame. The cursor is backed by a query, so it stays valid across structural changes.
+         *
+         * @tparam Components The types of the components to filter by.
+         * @tparam Excluded The types of the components an entity must not own.
+         * @param exclude Optional list of excluded components, e.g. ecs::exclude<dirty>.
+         * @return The cursor, positioned before its first pass.
+         */
+        template<typename... Components, typename... Excluded>
+        [[nodiscard]] basic_cursor<Config> cursor(exclude_t<Excluded...> excluded = exclude_t<Excluded...>{}) {
+            return basic_cursor<Config>{query<Components...>(excluded), this};
+        }
+
+        /**
+         * @brief Exports the pool of T as read-only column, without copying. The spans of the column are invalidated
+         * by the next structural change of the pool, so it should be read between ticks or converted to a snapshot.
+         *
+         * @tparam T The type of the component, has to be trivially copyable and stored densely.
+         * @return The column, empty if no component of type T was added yet.
+         */
+        template<typename T>
+        [[nodiscard]] basic_column<T, Config> column() const noexcept {
+            return basic_column<T, Config>{get_component_ptr<T>()};
+        }
+
+        /**
+         * @brief Copies the pools of the specified components, e.g. between two ticks. The snapshot owns its data,
+         * so it can be read by other threads while the world is modified.
+         *
+         * @tparam Components The types of the components to copy.
+         * @return The snapshot holding one column per component.
+         */
+        template<typename... Components>
+        [[nodiscard]] basic_snapshot<Config> snapshot() const {
+            basic_snapshot<Config> result;
+            (result.add(column<Components>()), ...);
+            return result;
+        }
+
+        /**
+         * @brief Transforms every component of type T and reduces the results on several threads. The pool is split
+         * into its storage pages, each page is a contiguous array, so simple kernels can be vectorized.
+         *
+         * @tparam T The type of the component, has to be trivially copyable and stored densely.
+         * @param identity Neutral element of reduce, every partial result starts with it.
+         * @param reduce Associative callable combining two results, e.g. std::plus<>.
+         * @param transform Callable taking (T const&), returns a result. It is called concurrently.
+         * @param options Number of threads and whether the combine order is fixed, the chunk size is ignored.
+         * @return The reduced result, identity if no component of type T exists.
+         */
+        template<typename T, typename R, typename Reduce, typename Transform>
+        R transform_reduce(R identity, Reduce &&reduce, Transform &&transform,
+                           reduce_options const &options = {}) const {
+            auto const source = column<T>();
+            auto const reduce_page = [&source, &reduce, &transform](std::size_t index, R accumulator) -> R {
+                for (auto const &value: source.chunk(index).values) {
+                    accumulator = reduce(std::move(accumulator), transform(value));
+                }
+                return accumulator;
+            };
+            return detail::parallel_reduce(source.chunk_count(), std::move(identity), reduce_page, reduce, options);
+        }
+
+        /**
+         * @brief Reduces every component of type T on several threads, see transform_reduce.
+         *
+         * @tparam T The type of the component, has to be trivially copyable and stored densely.
+         * @param identity Neutral element of reduce.
+         * @param reduce Associative callable combining two components.
+         * @param options Number of threads and whether the combine order is fixed.
+         * @return The reduced component, identity if no component of type T exists.
+         */
+        template<typename T, typename Reduce>
+        T reduce(T identity, Reduce &&reduce, reduce_options const &options = {}) const {
+            return transform_reduce<T>(std::move(identity), std::forward<Reduce>(reduce),
+                                       [](T const &component) { return component; }, options);
+        }
+
+        /**
+         * @brief Retrieves the number of distinct queries maintained by the ecs.
+         *
+         * @return The number of query storages, handles with the same components share one storage.
+         */
+        [[nodiscard]] std::size_t query_count() const noexcept { return m_queries.size(); }
+
+        /**
+         * @brief Makes child the first child of parent in the hierarchy. A previous parent of child is replaced.
+         *
+         * @param child The entity to attach.
+         * @param parent The new parent of child.
+         * @return An error indicating the result of the operation.
+         *         Success: error::ok
+         *         Else:    error::not_found if child or parent is not alive
+         *                  error::failed if child is parent or an ancestor of parent
+         */
+        error attach(entity_type child, entity_type parent) {
+            if (!m_entities.contains(child) || !m_entities.contains(parent)) {
+                return error::not_found;
+            }
+            return m_hierarchy.attach(child, parent);
+        }
+
+        /**
+         * @brief Detaches child from its parent, child and its descendants form a new tree.
+         *
+         * @param child The entity to detach.
+         * @return An error indicating the result of the operation.
+         *         Success: error::ok
+         *         Else:    error::not_found
+         */
+        error detach(entity_type child) { return m_hierarchy.detach(child); }
+
+        /**
+         * @brief Retrieves the parent of an entity.
+         *
+         * @param e The entity.
+         * @return The parent or null_entity for roots and entities outside of the hierarchy.
+         */
+        [[nodiscard]] entity_type parent(entity_type e) const { return m_hierarchy.parent(e); }
+
+        /**
+         * @brief Retrieves all related entities, iterating it visits every parent before its children.
+         *
+         * @return The hierarchy of the ecs.
+         */
+        [[nodiscard]] basic_hierarchy<Config> const &hierarchy() const { return m_hierarchy; }
+
+        /**
+         * @brief Constructs a context resource of type T, an existing resource of the same type is replaced.
+         * Context resources are not bound to an entity and survive clear().
+         *
+         * @tparam T The type of the resource.
+         * @param args Arguments forwarded to the constructor of T.
+         * @return A reference to the new resource.
+         */
+        template<typename T, typename... Args>
+        T &ctx_emplace(Args &&...args) {
+            return m_context.emplace<T>(std::forward<Args>(args)...);
+        }
+
+        /**
+         * @brief Retrieves a reference to the context resource of type T.
+         *
+         * @tparam T The type of the resource.
+         * @return A reference to the resource.
+         * @throws If no resource of type T is present an std::out_of_range exception is thrown
+         */
+        template<typename T>
+        [[nodiscard]] T &ctx() {
+            return m_context.get<T>();
+        }
+
+        template<typename T>
+        [[nodiscard]] T const &ctx() const {
+            return m_context.get<T>();
+        }
+
+        /**
+         * @brief Retrieves a pointer to the context resource of type T.
+         *
+         * @tparam T The type of the resource.
+         * @return A pointer to the resource or nullptr if not present.
+         */
+        template<typename T>
+        [[nodiscard]] T *ctx_find() {
+            return m_context.find<T>();
+        }
+
+        template<typename T>
+        [[nodiscard]] T const *ctx_find() const {
+            return m_context.find<T>();
+        }
+
+        /**
+         * @brief Checks if a context resource of type T is present.
+         *
+         * @tparam T The type of the resource.
+         * @return true if the resource is present, false otherwise.
+         */
+        template<typename T>
+        [[nodiscard]] bool ctx_contains() const {
+            return m_context.contains<T>();
+        }
+
+        /**
+         * @brief Destroys the context resource of type T.
+         *
+         * @tparam T The type of the resource.
+         * @return An error indicating the result of the operation.
+         *         Success: error::ok
+         *         Else:    error::not_found
+         */
+        template<typename T>
+        error ctx_erase() {
+            return m_context.erase<T>();
+        }
+
+        /**
+         * @brief Reports size, memory usage and structural change counters of every component pool.
+         *
+         * @return One entry per registered component type.
+         */
+        [[nodiscard]] std::vector<pool_stats> stats() const {
+            std::vector<pool_stats> result;
+            result.reserve(m_components.size());
+            for (auto const &components: m_components) {
+                if (components) {
+                    result.emplace_back(components->stats());
+                }
+            }
+            return result;
         }
     };
 
+    using ecs = basic_ecs<default_config>;
 } // namespace ecs
+#include "prefab.tpp"
+#include "query.tpp"
+#include "cursor.tpp"
 #include "view.tpp"
 
+namespace ecs {
+    extern template class basic_ecs<default_config>;
+}
+
 #endif // ESC_HPP
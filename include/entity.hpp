@@ -4,29 +4,218 @@
 
 #ifndef ENTITY_HPP
 #define ENTITY_HPP
-#include <queue>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <mutex>
+#include <span>
 #include <unordered_set>
+#include <vector>
 
+#include "config.hpp"
 #include "error.hpp"
 #include "types.hpp"
 
 namespace ecs {
-    class entity_store {
+    // Order in which destroyed entity indices are handed out again. Only configs with version bits tell a stale handle
+    // from the new entity on its index, without them a stale handle aliases the new entity under every policy.
+    enum class recycle_policy {
+        // Oldest first, the default
+        fifo,
+        // Most recently destroyed first, its memory is likely still cached. Without version bits a stale handle
+        // aliases the next created entity.
+        lifo,
+        // Smallest index first, keeps the living indices dense
+        lowest_index,
+    };
+
+    namespace detail {
+        // Atomic counter which can be copied, copies are only valid while no other thread uses it
+        class atomic_counter {
+        private:
+            std::atomic<std::size_t> m_value{};
+
+        public:
+            atomic_counter() = default;
+            atomic_counter(atomic_counter const &other) : m_value{other.load()} {}
+            atomic_counter &operator=(atomic_counter const &other) {
+                m_value.store(other.load(), std::memory_order_relaxed);
+                return *this;
+            }
+
+            [[nodiscard]] std::size_t load() const { return m_value.load(std::memory_order_relaxed); }
+            std::size_t fetch_add() { return m_value.fetch_add(1, std::memory_order_relaxed); }
+        };
+    } // namespace detail
+
+    /**
+     * Living entities and the free list of released handles. All arrays live in the storage of the config's backend,
+     * so with mapped_backend the store reserves address space for Config::index_count entities instead of using the
+     * heap.
+     */
+    template<typename Config>
+    class basic_entity_store {
+    public:
+        using entity_type = typename Config::entity_type;
+        using const_iterator = std::reverse_iterator<entity_type const *>;
+
     private:
-        std::queue<entity> m_available_entities{};
-        std::unordered_set<entity> m_living_entities{};
-        std::size_t m_total_entity_count{};
+        template<typename T, std::size_t MaxElements>
+        using vector_type = typename Config::backend_type::template vector<T, MaxElements>;
+
+        // Dense and unordered, destroying an entity moves the last one into its place
+        vector_type<entity_type, Config::index_count> m_living_entities{};
+        // Position in m_living_entities indexed by entity index, only meaningful for living entities
+        typename Config::template index_storage_type<entity_type> m_positions{};
+        // Released handles from m_available_begin on, kept as min heap by index for recycle_policy::lowest_index.
+        // fifo takes the front, the taken part is dropped once it is as long as the rest, which bounds the array
+        // by twice the number of indices.
+        vector_type<entity_type, 2 * Config::index_count> m_available_entities{};
+        std::size_t m_available_begin{};
+        // Fresh indices handed out by create and reserve
+        detail::atomic_counter m_total_entity_count{};
+        // Fresh indices below are living or were destroyed, the ones above may be reserved but not adopted yet
+        std::size_t m_adopted_entity_count{};
+        // Fresh indices handed out by create above m_adopted_entity_count
+        std::vector<std::size_t> m_created_unadopted{};
+        recycle_policy m_policy{recycle_policy::fifo};
+
+        static bool higher_index(entity_type a, entity_type b) { return Config::to_index(a) > Config::to_index(b); }
+        std::span<entity_type> available() {
+            return std::span<entity_type>{m_available_entities}.subspan(m_available_begin);
+        }
+        void release(entity_type e);
+        void drop_taken();
+        void insert_living(entity_type e);
 
     public:
-        entity_store() = default;
+        basic_entity_store() = default;
+        explicit basic_entity_store(recycle_policy policy) : m_policy{policy} {}
 
-        [[nodiscard]] entity create();
-        error destroy(entity);
+        // Returns Config::null if all indices are in use
+        [[nodiscard]] entity_type create();
+        // Thread safe, even while one other thread uses the store. The handle has a fresh index and is not living
+        // until flush adopts it. Returns Config::null if all indices are in use.
+        [[nodiscard]] entity_type reserve();
+        // Adopts all reserved handles as living entities, only valid while no thread reserves
+        std::size_t flush();
+        error destroy(entity_type);
         error clear();
-        std::unordered_set<entity>::iterator begin() { return m_living_entities.begin(); }
-        std::unordered_set<entity>::iterator end() { return m_living_entities.end(); }
-        [[nodiscard]] std::unordered_set<entity>::const_iterator begin() const { return m_living_entities.begin(); }
-        [[nodiscard]] std::unordered_set<entity>::const_iterator end() const { return m_living_entities.end(); }
+        void set_policy(recycle_policy policy);
+        [[nodiscard]] recycle_policy policy() const { return m_policy; }
+        // Releases memory of the free list and the living set not needed for the current entities
+        void shrink_to_fit();
+        [[nodiscard]] std::size_t size() const { return m_living_entities.size(); }
+        [[nodiscard]] bool contains(entity_type e) const;
+        // Iterates the most recently created entities first
+        [[nodiscard]] const_iterator begin() const {
+            return const_iterator{m_living_entities.data() + m_living_entities.size()};
+        }
+        [[nodiscard]] const_iterator end() const { return const_iterator{m_living_entities.data()}; }
     };
+
+    /**
+     * Entity store which allows create and destroy from many threads at once.
+     * Entities are distributed over independently locked shards by their index, each shard owns the free list of its
+     * indices. Fresh indices are handed out by an atomic counter. Iteration, clear and size are only valid at sync
+     * points, when no other thread creates or destroys entities.
+     */
+    template<typename Config>
+    class basic_concurrent_entity_store {
+    public:
+        using entity_type = typename Config::entity_type;
+        static constexpr std::size_t shard_count = 16;
+
+    private:
+        struct alignas(64) shard {
+            mutable std::mutex mutex{};
+            std::vector<entity_type> available_entities{};
+            std::unordered_set<entity_type> living_entities{};
+        };
+        using shard_array = std::array<shard, shard_count>;
+        using shard_iterator = typename std::unordered_set<entity_type>::const_iterator;
+
+        shard_array m_shards{};
+        std::atomic<std::size_t> m_total_entity_count{};
+
+        static std::size_t shard_of(entity_type e) { return Config::to_index(e) % shard_count; }
+
+    public:
+        class iterator {
+        private:
+            shard_array const *m_shards{nullptr};
+            std::size_t m_shard{};
+            shard_iterator m_current{};
+
+            void skip_empty() {
+                while (m_shard < shard_count && m_current == (*m_shards)[m_shard].living_entities.end()) {
+                    if (++m_shard < shard_count) {
+                        m_current = (*m_shards)[m_shard].living_entities.begin();
+                    }
+                }
+            }
+
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = entity_type;
+            using difference_type = std::ptrdiff_t;
+            using pointer = entity_type const *;
+            using reference = entity_type const &;
+
+            iterator() = default;
+            iterator(shard_array const *shards, std::size_t shard) : m_shards{shards}, m_shard{shard} {
+                if (m_shard < shard_count) {
+                    m_current = (*m_shards)[m_shard].living_entities.begin();
+                    skip_empty();
+                }
+            }
+
+            reference operator*() const { return *m_current; }
+            pointer operator->() const { return &*m_current; }
+
+            iterator &operator++() {
+                ++m_current;
+                skip_empty();
+                return *this;
+            }
+            iterator operator++(int) {
+                auto const copy = *this;
+                ++*this;
+                return copy;
+            }
+
+            bool operator==(iterator const &other) const {
+                if (m_shard != other.m_shard) {
+                    return false;
+                }
+                return m_shard == shard_count || m_current == other.m_current;
+            }
+        };
+
+        basic_concurrent_entity_store() = default;
+
+        // Thread safe, returns Config::null if all indices are in use
+        [[nodiscard]] entity_type create();
+        // Thread safe
+        error destroy(entity_type);
+        // Thread safe
+        [[nodiscard]] bool contains(entity_type) const;
+
+        error clear();
+        [[nodiscard]] std::size_t size() const;
+        [[nodiscard]] iterator begin() const { return iterator{&m_shards, 0}; }
+        [[nodiscard]] iterator end() const { return iterator{&m_shards, shard_count}; }
+    };
+
+    using entity_store = basic_entity_store<default_config>;
+    using concurrent_entity_store = basic_concurrent_entity_store<default_config>;
+} // namespace ecs
+
+#include "entity.tpp"
+
+namespace ecs {
+    extern template class basic_entity_store<default_config>;
+    extern template class basic_concurrent_entity_store<default_config>;
 } // namespace ecs
 #endif // ENTITY_HPP
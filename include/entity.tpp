@@ -0,0 +1,229 @@
+#ifndef ENTITY_TPP
+#define ENTITY_TPP
+#include <algorithm>
+#include <functional>
+#include <thread>
+
+namespace ecs {
+    template<typename Config>
+    void basic_entity_store<Config>::release(entity_type e) {
+        m_available_entities.push_back(e);
+        if (m_policy == recycle_policy::lowest_index) {
+            auto const entities = available();
+            std::push_heap(entities.begin(), entities.end(), higher_index);
+        }
+    }
+
+    template<typename Config>
+    void basic_entity_store<Config>::drop_taken() {
+        if (m_available_begin >= m_available_entities.size() - m_available_begin) {
+            auto const first = m_available_entities.begin();
+            m_available_entities.erase(first, first + static_cast<std::ptrdiff_t>(m_available_begin));
+            m_available_begin = 0;
+        }
+    }
+
+    template<typename Config>
+    void basic_entity_store<Config>::insert_living(entity_type e) {
+        auto const index = static_cast<std::size_t>(Config::to_index(e));
+        m_positions.reserve(index + 1);
+        m_positions[index] = static_cast<entity_type>(m_living_entities.size());
+        m_living_entities.push_back(e);
+    }
+
+    template<typename Config>
+    typename basic_entity_store<Config>::entity_type basic_entity_store<Config>::create() {
+        entity_type new_entity{};
+        if (m_available_begin < m_available_entities.size()) {
+            switch (m_policy) {
+                case recycle_policy::fifo:
+                    new_entity = m_available_entities[m_available_begin++];
+                    break;
+                case recycle_policy::lowest_index: {
+                    auto const entities = available();
+                    std::pop_heap(entities.begin(), entities.end(), higher_index);
+                    [[fallthrough]];
+                }
+                case recycle_policy::lifo:
+                    new_entity = m_available_entities.back();
+                    m_available_entities.pop_back();
+                    break;
+            }
+            drop_taken();
+        } else if (auto const index = m_total_entity_count.fetch_add(); index < Config::index_count) {
+            new_entity = static_cast<entity_type>(index);
+            // Without reservations in between every fresh index is adopted right away
+            if (index == m_adopted_entity_count) {
+                ++m_adopted_entity_count;
+            } else {
+                m_created_unadopted.push_back(index);
+            }
+        } else {
+            return Config::null;
+        }
+        insert_living(new_entity);
+        return new_entity;
+    }
+
+    template<typename Config>
+    typename basic_entity_store<Config>::entity_type basic_entity_store<Config>::reserve() {
+        auto const index = m_total_entity_count.fetch_add();
+        return index < Config::index_count ? static_cast<entity_type>(index) : Config::null;
+    }
+
+    template<typename Config>
+    std::size_t basic_entity_store<Config>::flush() {
+        auto const total = std::min<std::size_t>(m_total_entity_count.load(), Config::index_count);
+        std::sort(m_created_unadopted.begin(), m_created_unadopted.end());
+        std::size_t adopted{};
+        for (auto index = m_adopted_entity_count; index < total; ++index) {
+            if (!std::binary_search(m_created_unadopted.begin(), m_created_unadopted.end(), index)) {
+                insert_living(static_cast<entity_type>(index));
+                ++adopted;
+            }
+        }
+        m_adopted_entity_count = std::max(m_adopted_entity_count, total);
+        m_created_unadopted.clear();
+        return adopted;
+    }
+
+    template<typename Config>
+    bool basic_entity_store<Config>::contains(entity_type e) const {
+        auto const index = static_cast<std::size_t>(Config::to_index(e));
+        if (index >= m_positions.capacity()) {
+            return false;
+        }
+        auto const position = static_cast<std::size_t>(m_positions[index]);
+        return position < m_living_entities.size() && m_living_entities[position] == e;
+    }
+
+    template<typename Config>
+    error basic_entity_store<Config>::destroy(entity_type e) {
+        if (!contains(e)) {
+            return error::not_found;
+        }
+
+        auto const position = m_positions[Config::to_index(e)];
+        auto const last = m_living_entities.back();
+        m_living_entities[position] = last;
+        m_positions[Config::to_index(last)] = position;
+        m_living_entities.pop_back();
+        release(Config::next_version(e));
+        return error::ok;
+    }
+
+    template<typename Config>
+    error basic_entity_store<Config>::clear() {
+        for (auto const e: m_living_entities) {
+            release(Config::next_version(e));
+        }
+        m_living_entities.clear();
+        return error::ok;
+    }
+
+    template<typename Config>
+    void basic_entity_store<Config>::set_policy(recycle_policy policy) {
+        if (policy == recycle_policy::lowest_index && m_policy != recycle_policy::lowest_index) {
+            auto const entities = available();
+            std::make_heap(entities.begin(), entities.end(), higher_index);
+        }
+        m_policy = policy;
+    }
+
+    template<typename Config>
+    void basic_entity_store<Config>::shrink_to_fit() {
+        auto const first = m_available_entities.begin();
+        m_available_entities.erase(first, first + static_cast<std::ptrdiff_t>(m_available_begin));
+        m_available_begin = 0;
+        m_available_entities.shrink_to_fit();
+
+        std::size_t end{};
+        for (auto const e: m_living_entities) {
+            end = std::max<std::size_t>(end, static_cast<std::size_t>(Config::to_index(e)) + 1);
+        }
+        m_positions.shrink(end);
+        m_living_entities.shrink_to_fit();
+    }
+
+    namespace detail {
+        // Shard whose free list a thread drains first, spreads threads over the shards
+        inline std::size_t home_shard(std::size_t shard_count) {
+            thread_local std::size_t const hash = std::hash<std::thread::id>{}(std::this_thread::get_id());
+            return hash % shard_count;
+        }
+    } // namespace detail
+
+    template<typename Config>
+    typename basic_concurrent_entity_store<Config>::entity_type basic_concurrent_entity_store<Config>::create() {
+        auto const home = detail::home_shard(shard_count);
+        for (std::size_t offset = 0; offset < shard_count; ++offset) {
+            auto &shard = m_shards[(home + offset) % shard_count];
+            // only wait for the home shard, busy shards are skipped when stealing
+            std::unique_lock lock{shard.mutex, std::defer_lock};
+            if (offset == 0) {
+                lock.lock();
+            } else if (!lock.try_lock()) {
+                continue;
+            }
+            if (!shard.available_entities.empty()) {
+                auto const new_entity = shard.available_entities.back();
+                shard.available_entities.pop_back();
+                shard.living_entities.insert(new_entity);
+                return new_entity;
+            }
+        }
+
+        auto const index = m_total_entity_count.fetch_add(1, std::memory_order_relaxed);
+        if (index >= Config::index_mask) {
+            return Config::null;
+        }
+        auto const new_entity = static_cast<entity_type>(index);
+        auto &shard = m_shards[shard_of(new_entity)];
+        std::scoped_lock lock{shard.mutex};
+        shard.living_entities.insert(new_entity);
+        return new_entity;
+    }
+
+    template<typename Config>
+    error basic_concurrent_entity_store<Config>::destroy(entity_type e) {
+        auto &shard = m_shards[shard_of(e)];
+        std::scoped_lock lock{shard.mutex};
+        if (auto const ok = shard.living_entities.erase(e); ok == 0) {
+            return error::not_found;
+        }
+        shard.available_entities.push_back(Config::next_version(e));
+        return error::ok;
+    }
+
+    template<typename Config>
+    bool basic_concurrent_entity_store<Config>::contains(entity_type e) const {
+        auto const &shard = m_shards[shard_of(e)];
+        std::scoped_lock lock{shard.mutex};
+        return shard.living_entities.contains(e);
+    }
+
+    template<typename Config>
+    error basic_concurrent_entity_store<Config>::clear() {
+        for (auto &shard: m_shards) {
+            std::scoped_lock lock{shard.mutex};
+            for (auto const e: shard.living_entities) {
+                shard.available_entities.push_back(Config::next_version(e));
+            }
+            shard.living_entities.clear();
+        }
+        return error::ok;
+    }
+
+    template<typename Config>
+    std::size_t basic_concurrent_entity_store<Config>::size() const {
+        std::size_t count{};
+        for (auto const &shard: m_shards) {
+            std::scoped_lock lock{shard.mutex};
+            count += shard.living_entities.size();
+        }
+        return count;
+    }
+} // namespace ecs
+
+
+#endif
@@ -0,0 +1,111 @@
+//
+// Created by HP on 19.10.2026.
+//
+
+#ifndef HIERARCHY_HPP
+#define HIERARCHY_HPP
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+#include "config.hpp"
+#include "error.hpp"
+#include "types.hpp"
+
+namespace ecs {
+    template<typename Config>
+    struct basic_relationship {
+        using entity_type = typename Config::entity_type;
+
+        entity_type parent{Config::null};
+        entity_type first_child{Config::null};
+        entity_type next_sibling{Config::null};
+        entity_type prev_sibling{Config::null};
+        std::size_t depth{};
+    };
+
+    /**
+     * Parent/child relations of entities. Nodes are stored densely and grouped by depth,
+     * so iterating from begin to end always visits a parent before any of its children.
+     * The order is maintained incrementally, inserting or removing a node moves at most one node per depth level.
+     */
+    template<typename Config>
+    class basic_hierarchy {
+    public:
+        using entity_type = typename Config::entity_type;
+        using relationship = basic_relationship<Config>;
+
+    private:
+        std::vector<entity_type> m_dense{};
+        std::vector<relationship> m_relations{};
+        std::unordered_map<entity_type, std::size_t> m_index{};
+        // End offset in m_dense of every depth level, level d spans [m_depth_end[d - 1], m_depth_end[d])
+        std::vector<std::size_t> m_depth_end{};
+
+        [[nodiscard]] std::size_t depth_begin(std::size_t depth) const {
+            return depth == 0 ? 0 : m_depth_end[depth - 1];
+        }
+        relationship &relation(entity_type e) { return m_relations[m_index.at(e)]; }
+
+        void move_node(std::size_t from, std::size_t to);
+        void insert_node(entity_type e, relationship const &relation);
+        relationship erase_node(entity_type e);
+        void unlink(entity_type e);
+        void link(entity_type child, entity_type parent);
+        void update_depth(entity_type root, std::size_t depth);
+        [[nodiscard]] bool is_ancestor(entity_type ancestor, entity_type e) const;
+
+    public:
+        basic_hierarchy() = default;
+
+        /**
+         * @brief Makes child the first child of parent. A previous parent of child is replaced.
+         * Entities unknown to the hierarchy are added as roots first.
+         *
+         * @return error::ok, or error::failed if child is parent or an ancestor of parent
+         */
+        error attach(entity_type child, entity_type parent);
+        // Turns child into a root, its subtree moves along
+        error detach(entity_type child);
+        // Removes e from the hierarchy, its children become roots
+        error remove(entity_type e);
+        // Removes root and all its descendants from the hierarchy
+        error remove_subtree(entity_type root);
+        void clear();
+        // Releases memory not needed for the current nodes
+        void shrink_to_fit();
+
+        [[nodiscard]] bool contains(entity_type e) const { return m_index.contains(e); }
+        [[nodiscard]] relationship const *find(entity_type e) const;
+        [[nodiscard]] entity_type parent(entity_type e) const;
+        [[nodiscard]] std::vector<entity_type> children(entity_type e) const;
+        // Root followed by all descendants, parents before children
+        [[nodiscard]] std::vector<entity_type> subtree(entity_type root) const;
+
+        [[nodiscard]] std::size_t size() const { return m_dense.size(); }
+        [[nodiscard]] std::size_t depth() const { return m_depth_end.size(); }
+
+        // Dense access in depth order
+        [[nodiscard]] entity_type at(std::size_t index) const { return m_dense[index]; }
+        [[nodiscard]] relationship const &relation_at(std::size_t index) const { return m_relations[index]; }
+
+        template<typename Func>
+        void each(Func &&func) const {
+            for (std::size_t i = 0; i < m_dense.size(); ++i) {
+                func(m_dense[i], m_relations[i]);
+            }
+        }
+
+        [[nodiscard]] std::vector<entity_type>::const_iterator begin() const { return m_dense.begin(); }
+        [[nodiscard]] std::vector<entity_type>::const_iterator end() const { return m_dense.end(); }
+    };
+
+    using relationship = basic_relationship<default_config>;
+    using hierarchy = basic_hierarchy<default_config>;
+} // namespace ecs
+
+#include "hierarchy.tpp"
+
+namespace ecs {
+    extern template class basic_hierarchy<default_config>;
+}
+#endif // HIERARCHY_HPP
@@ -0,0 +1,231 @@
+#ifndef HIERARCHY_TPP
+#define HIERARCHY_TPP
+
+namespace ecs {
+    template<typename Config>
+    void basic_hierarchy<Config>::move_node(std::size_t from, std::size_t to) {
+        m_dense[to] = m_dense[from];
+        m_relations[to] = m_relations[from];
+        m_index[m_dense[to]] = to;
+    }
+
+    template<typename Config>
+    void basic_hierarchy<Config>::insert_node(entity_type e, relationship const &relation) {
+        auto const depth = relation.depth;
+        while (m_depth_end.size() <= depth) {
+            m_depth_end.push_back(m_dense.size());
+        }
+
+        // open a hole at the end and bubble it up to the end of the target level,
+        // every deeper level hands its first node over to its end
+        m_dense.push_back(e);
+        m_relations.push_back(relation);
+        auto hole = m_dense.size() - 1;
+        for (auto level = m_depth_end.size() - 1; level > depth; --level) {
+            if (auto const first = depth_begin(level); first != hole) {
+                move_node(first, hole);
+                hole = first;
+            }
+            ++m_depth_end[level];
+        }
+        m_dense[hole] = e;
+        m_relations[hole] = relation;
+        m_index[e] = hole;
+        ++m_depth_end[depth];
+    }
+
+    template<typename Config>
+    typename basic_hierarchy<Config>::relationship basic_hierarchy<Config>::erase_node(entity_type e) {
+        auto const index = m_index.at(e);
+        auto const removed = m_relations[index];
+
+        // fill the hole with the last node of its level and push the hole down through all deeper levels
+        auto hole = index;
+        for (auto level = removed.depth; level < m_depth_end.size(); ++level) {
+            if (auto const last = m_depth_end[level] - 1; last != hole) {
+                move_node(last, hole);
+                hole = last;
+            }
+            --m_depth_end[level];
+        }
+        m_dense.pop_back();
+        m_relations.pop_back();
+        m_index.erase(e);
+
+        while (!m_depth_end.empty() && m_depth_end.back() == depth_begin(m_depth_end.size() - 1)) {
+            m_depth_end.pop_back();
+        }
+        return removed;
+    }
+
+    template<typename Config>
+    void basic_hierarchy<Config>::unlink(entity_type e) {
+        auto const current = relation(e);
+        if (current.parent == Config::null) {
+            return;
+        }
+        if (current.prev_sibling != Config::null) {
+            relation(current.prev_sibling).next_sibling = current.next_sibling;
+        } else {
+            relation(current.parent).first_child = current.next_sibling;
+        }
+        if (current.next_sibling != Config::null) {
+            relation(current.next_sibling).prev_sibling = current.prev_sibling;
+        }
+
+        auto &unlinked = relation(e);
+        unlinked.parent = Config::null;
+        unlinked.prev_sibling = Config::null;
+        unlinked.next_sibling = Config::null;
+    }
+
+    template<typename Config>
+    void basic_hierarchy<Config>::link(entity_type child, entity_type parent) {
+        auto const first_child = relation(parent).first_child;
+        if (first_child != Config::null) {
+            relation(first_child).prev_sibling = child;
+        }
+        relation(parent).first_child = child;
+
+        auto &linked = relation(child);
+        linked.parent = parent;
+        linked.prev_sibling = Config::null;
+        linked.next_sibling = first_child;
+    }
+
+    template<typename Config>
+    void basic_hierarchy<Config>::update_depth(entity_type root, std::size_t depth) {
+        auto const old_depth = relation(root).depth;
+        if (old_depth == depth) {
+            return;
+        }
+        for (auto const e: subtree(root)) {
+            auto moved = erase_node(e);
+            moved.depth = moved.depth - old_depth + depth;
+            insert_node(e, moved);
+        }
+    }
+
+    template<typename Config>
+    bool basic_hierarchy<Config>::is_ancestor(entity_type ancestor, entity_type e) const {
+        for (auto current = parent(e); current != Config::null; current = parent(current)) {
+            if (current == ancestor) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    template<typename Config>
+    error basic_hierarchy<Config>::attach(entity_type child, entity_type parent) {
+        if (child == parent || is_ancestor(child, parent)) {
+            return error::failed;
+        }
+        if (!contains(parent)) {
+            insert_node(parent, {});
+        }
+        if (!contains(child)) {
+            insert_node(child, {});
+        }
+        unlink(child);
+        link(child, parent);
+        update_depth(child, relation(parent).depth + 1);
+        return error::ok;
+    }
+
+    template<typename Config>
+    error basic_hierarchy<Config>::detach(entity_type child) {
+        if (!contains(child)) {
+            return error::not_found;
+        }
+        unlink(child);
+        update_depth(child, 0);
+        return error::ok;
+    }
+
+    template<typename Config>
+    error basic_hierarchy<Config>::remove(entity_type e) {
+        if (!contains(e)) {
+            return error::not_found;
+        }
+        for (auto const child: children(e)) {
+            detach(child);
+        }
+        unlink(e);
+        erase_node(e);
+        return error::ok;
+    }
+
+    template<typename Config>
+    error basic_hierarchy<Config>::remove_subtree(entity_type root) {
+        if (!contains(root)) {
+            return error::not_found;
+        }
+        unlink(root);
+        for (auto const e: subtree(root)) {
+            erase_node(e);
+        }
+        return error::ok;
+    }
+
+    template<typename Config>
+    void basic_hierarchy<Config>::clear() {
+        m_dense.clear();
+        m_relations.clear();
+        m_index.clear();
+        m_depth_end.clear();
+    }
+
+    template<typename Config>
+    void basic_hierarchy<Config>::shrink_to_fit() {
+        m_dense.shrink_to_fit();
+        m_relations.shrink_to_fit();
+        m_depth_end.shrink_to_fit();
+        std::unordered_map<entity_type, std::size_t>{m_index.begin(), m_index.end()}.swap(m_index);
+    }
+
+    template<typename Config>
+    typename basic_hierarchy<Config>::relationship const *basic_hierarchy<Config>::find(entity_type e) const {
+        if (auto const it = m_index.find(e); it != m_index.end()) {
+            return &m_relations[it->second];
+        }
+        return nullptr;
+    }
+
+    template<typename Config>
+    typename basic_hierarchy<Config>::entity_type basic_hierarchy<Config>::parent(entity_type e) const {
+        if (auto const *relation = find(e)) {
+            return relation->parent;
+        }
+        return Config::null;
+    }
+
+    template<typename Config>
+    std::vector<typename basic_hierarchy<Config>::entity_type> basic_hierarchy<Config>::children(entity_type e) const {
+        std::vector<entity_type> result;
+        auto const *relation = find(e);
+        for (auto child = relation ? relation->first_child : Config::null; child != Config::null;
+             child = find(child)->next_sibling) {
+            result.push_back(child);
+        }
+        return result;
+    }
+
+    template<typename Config>
+    std::vector<typename basic_hierarchy<Config>::entity_type> basic_hierarchy<Config>::subtree(entity_type root) const {
+        if (!contains(root)) {
+            return {};
+        }
+        // breadth first, so every parent precedes its children
+        std::vector<entity_type> result{root};
+        for (std::size_t i = 0; i < result.size(); ++i) {
+            for (auto child = find(result[i])->first_child; child != Config::null; child = find(child)->next_sibling) {
+                result.push_back(child);
+            }
+        }
+        return result;
+    }
+} // namespace ecs
+
+
+#endif
@@ -0,0 +1,294 @@
+//
+// Created by HP on 19.10.2026.
+//
+
+#ifndef MAPPED_HPP
+#define MAPPED_HPP
+#include <algorithm>
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace ecs {
+    enum class huge_pages {
+        none,
+        // Advises the kernel to back the region with transparent huge pages where possible
+        transparent,
+        // Maps the region from the reserved huge page pool, falls back to normal pages if the pool is empty
+        hugetlb,
+    };
+
+    /**
+     * Range of reserved address space whose pages are committed on demand. Anonymous regions start without any
+     * committed memory, file backed regions map the whole file and keep their content after the region is gone.
+     * Huge pages are only used on Linux.
+     */
+    class mapped_region {
+    private:
+        std::byte *m_data{nullptr};
+        std::size_t m_size{};
+        std::size_t m_committed{};
+        std::size_t m_granularity{};
+        bool m_file_backed{false};
+
+        void release() noexcept;
+
+    public:
+        // Reserves bytes of address space, throws std::bad_alloc if that fails
+        explicit mapped_region(std::size_t bytes, huge_pages huge = huge_pages::none);
+        // Maps the file at path, it is created or grown to bytes. Throws std::system_error if that fails
+        mapped_region(std::filesystem::path const &path, std::size_t bytes);
+
+        mapped_region(mapped_region const &) = delete;
+        mapped_region &operator=(mapped_region const &) = delete;
+        mapped_region(mapped_region &&other) noexcept;
+        mapped_region &operator=(mapped_region &&other) noexcept;
+        ~mapped_region();
+
+        // Makes at least the first bytes readable and writable, throws std::bad_alloc if that fails
+        void commit(std::size_t bytes);
+        // Returns the memory behind the first bytes to the system, the address space stays reserved
+        void decommit(std::size_t bytes) noexcept;
+        // Writes modified pages of a file backed region to the file
+        void flush() noexcept;
+
+        [[nodiscard]] std::byte *data() const noexcept { return m_data; }
+        [[nodiscard]] std::size_t size() const noexcept { return m_size; }
+        [[nodiscard]] std::size_t committed() const noexcept { return m_committed; }
+        [[nodiscard]] bool file_backed() const noexcept { return m_file_backed; }
+    };
+
+    /**
+     * Drop-in replacement of paged_storage which reserves room for MaxElements up front and commits PageSize
+     * elements at a time. Elements never move and untouched pages cost no memory. A file backed storage keeps the
+     * raw bytes of its elements in the file, so the same file can be mapped again later without loading it.
+     */
+    template<typename T, std::size_t PageSize, std::size_t MaxElements, huge_pages Huge = huge_pages::none>
+    class mapped_storage {
+        static_assert(PageSize > 0 && (PageSize & (PageSize - 1)) == 0, "PageSize has to be a power of two");
+
+    private:
+        static constexpr std::size_t reserved_elements = (MaxElements + PageSize - 1) / PageSize * PageSize;
+
+        mapped_region m_region;
+        std::size_t m_capacity{};
+
+        [[nodiscard]] T *elements() const noexcept { return std::launder(reinterpret_cast<T *>(m_region.data())); }
+        // Elements of a file backed storage are its bytes, they are neither constructed nor destroyed
+        [[nodiscard]] bool owns_elements() const noexcept { return !m_region.file_backed(); }
+
+    public:
+        static constexpr std::size_t page_size = PageSize;
+
+        mapped_storage() : m_region{reserved_elements * sizeof(T), Huge} {}
+
+        explicit mapped_storage(std::filesystem::path const &path)
+            requires std::is_trivially_copyable_v<T>
+            : m_region{path, reserved_elements * sizeof(T)} {}
+
+        mapped_storage(mapped_storage const &) = delete;
+        mapped_storage &operator=(mapped_storage const &) = delete;
+
+        ~mapped_storage() {
+            if (owns_elements()) {
+                std::destroy_n(elements(), m_capacity);
+            }
+        }
+
+        T &operator[](std::size_t index) { return elements()[index]; }
+        T const &operator[](std::size_t index) const { return elements()[index]; }
+
+        // Commits pages until size elements are available
+        void reserve(std::size_t size) {
+            if (size <= m_capacity) {
+                return;
+            }
+            auto const capacity = (size + PageSize - 1) / PageSize * PageSize;
+            if (capacity > reserved_elements) {
+                throw std::bad_alloc{};
+            }
+            m_region.commit(capacity * sizeof(T));
+            if (owns_elements()) {
+                std::uninitialized_value_construct_n(elements() + m_capacity, capacity - m_capacity);
+            }
+            m_capacity = capacity;
+        }
+
+        // Assigns value to the elements [first, first + count)
+        void fill(std::size_t first, std::size_t count, T const &value) { std::fill_n(elements() + first, count, value); }
+
+        // Decommits the pages behind the first size elements
+        void shrink(std::size_t size) {
+            auto const capacity = (size + PageSize - 1) / PageSize * PageSize;
+            if (capacity >= m_capacity) {
+                return;
+            }
+            if (owns_elements()) {
+                std::destroy_n(elements() + capacity, m_capacity - capacity);
+            }
+            m_region.decommit(capacity * sizeof(T));
+            m_capacity = capacity;
+        }
+
+        void flush() noexcept { m_region.flush(); }
+
+        [[nodiscard]] std::size_t capacity() const { return m_capacity; }
+        [[nodiscard]] std::size_t page_count() const { return m_capacity / PageSize; }
+    };
+
+    /**
+     * Counterpart of raw_paged_storage in reserved address space, room for MaxElements elements of stride bytes
+     * is reserved up front and committed PageSize elements at a time.
+     */
+    template<std::size_t PageSize, std::size_t MaxElements, huge_pages Huge = huge_pages::none>
+    class raw_mapped_storage {
+        static_assert(PageSize > 0 && (PageSize & (PageSize - 1)) == 0, "PageSize has to be a power of two");
+
+    private:
+        static constexpr std::size_t reserved_elements = (MaxElements + PageSize - 1) / PageSize * PageSize;
+
+        std::size_t m_stride;
+        mapped_region m_region;
+        std::size_t m_capacity{};
+
+        // The region starts at a system page, larger alignments can not be guaranteed
+        static std::size_t stride_of(std::size_t size, std::size_t alignment) {
+            if (alignment == 0 || (alignment & (alignment - 1)) != 0 || alignment > 4096) {
+                throw std::invalid_argument("alignment has to be a power of two of at most 4096");
+            }
+            return (std::max<std::size_t>(size, 1) + alignment - 1) / alignment * alignment;
+        }
+
+    public:
+        static constexpr std::size_t page_size = PageSize;
+
+        // Throws std::invalid_argument if alignment is not a power of two or larger than a system page
+        raw_mapped_storage(std::size_t size, std::size_t alignment) :
+            m_stride{stride_of(size, alignment)}, m_region{reserved_elements * m_stride, Huge} {}
+
+        void *operator[](std::size_t index) { return m_region.data() + index * m_stride; }
+        void const *operator[](std::size_t index) const { return m_region.data() + index * m_stride; }
+
+        // Commits pages until size elements are available
+        void reserve(std::size_t size) {
+            if (size <= m_capacity) {
+                return;
+            }
+            auto const capacity = (size + PageSize - 1) / PageSize * PageSize;
+            if (capacity > reserved_elements) {
+                throw std::bad_alloc{};
+            }
+            m_region.commit(capacity * m_stride);
+            m_capacity = capacity;
+        }
+
+        // Decommits the pages behind the first size elements
+        void shrink(std::size_t size) {
+            auto const capacity = (size + PageSize - 1) / PageSize * PageSize;
+            if (capacity < m_capacity) {
+                m_region.decommit(capacity * m_stride);
+                m_capacity = capacity;
+            }
+        }
+
+        [[nodiscard]] std::size_t stride() const { return m_stride; }
+        [[nodiscard]] std::size_t capacity() const { return m_capacity; }
+        [[nodiscard]] std::size_t page_count() const { return m_capacity / PageSize; }
+    };
+
+    /**
+     * Contiguous array in reserved address space with the interface of std::vector that the dense arrays of entity
+     * stores and layouts use. Room for MaxElements is reserved up front and committed as the array grows, so growing
+     * never copies the elements.
+     */
+    template<typename T, std::size_t MaxElements, huge_pages Huge = huge_pages::none>
+    class mapped_vector {
+        static_assert(std::is_trivially_copyable_v<T>, "mapped_vector only holds trivially copyable elements");
+
+    private:
+        mapped_region m_region;
+        std::size_t m_size{};
+
+        [[nodiscard]] T *elements() const noexcept { return std::launder(reinterpret_cast<T *>(m_region.data())); }
+
+    public:
+        using value_type = T;
+        using iterator = T *;
+        using const_iterator = T const *;
+
+        mapped_vector() : m_region{MaxElements * sizeof(T), Huge} {}
+
+        mapped_vector(mapped_vector const &) = delete;
+        mapped_vector &operator=(mapped_vector const &) = delete;
+        mapped_vector(mapped_vector &&other) noexcept :
+            m_region{std::move(other.m_region)}, m_size{std::exchange(other.m_size, 0)} {}
+        mapped_vector &operator=(mapped_vector &&other) noexcept {
+            m_region = std::move(other.m_region);
+            m_size = std::exchange(other.m_size, 0);
+            return *this;
+        }
+
+        T &operator[](std::size_t index) noexcept { return elements()[index]; }
+        T const &operator[](std::size_t index) const noexcept { return elements()[index]; }
+        T &back() noexcept { return elements()[m_size - 1]; }
+        T const &back() const noexcept { return elements()[m_size - 1]; }
+
+        [[nodiscard]] T *data() noexcept { return elements(); }
+        [[nodiscard]] T const *data() const noexcept { return elements(); }
+        [[nodiscard]] iterator begin() noexcept { return elements(); }
+        [[nodiscard]] iterator end() noexcept { return elements() + m_size; }
+        [[nodiscard]] const_iterator begin() const noexcept { return elements(); }
+        [[nodiscard]] const_iterator end() const noexcept { return elements() + m_size; }
+
+        // Commits pages for size elements, throws std::bad_alloc beyond MaxElements
+        void reserve(std::size_t size) {
+            if (size > MaxElements) {
+                throw std::bad_alloc{};
+            }
+            m_region.commit(size * sizeof(T));
+        }
+
+        void push_back(T const &value) {
+            reserve(m_size + 1);
+            elements()[m_size++] = value;
+        }
+
+        void pop_back() noexcept { --m_size; }
+
+        iterator erase(const_iterator first, const_iterator last) noexcept {
+            auto *const target = elements() + (first - elements());
+            auto const *const tail = elements() + m_size;
+            std::copy(last, tail, target);
+            m_size -= static_cast<std::size_t>(last - first);
+            return target;
+        }
+
+        void clear() noexcept { m_size = 0; }
+
+        // Decommits the pages behind the elements
+        void shrink_to_fit() noexcept { m_region.decommit(m_size * sizeof(T)); }
+
+        [[nodiscard]] bool empty() const noexcept { return m_size == 0; }
+        [[nodiscard]] std::size_t size() const noexcept { return m_size; }
+        [[nodiscard]] std::size_t capacity() const noexcept { return m_region.committed() / sizeof(T); }
+    };
+
+    // Pool and index storage backed by mapped regions, see basic_config
+    template<huge_pages Huge = huge_pages::none>
+    struct mapped_backend {
+        // Every storage reserves room for its maximum up front, so worlds hand out at most MaxEntities indices
+        static constexpr bool reserves_address_space = true;
+
+        template<typename T, std::size_t PageSize, std::size_t MaxElements>
+        using storage = mapped_storage<T, PageSize, MaxElements, Huge>;
+        template<std::size_t PageSize, std::size_t MaxElements>
+        using raw_storage = raw_mapped_storage<PageSize, MaxElements, Huge>;
+        template<typename T, std::size_t MaxElements>
+        using vector = mapped_vector<T, MaxElements, Huge>;
+    };
+} // namespace ecs
+#endif // MAPPED_HPP
@@ -0,0 +1,33 @@
+//
+// Created by HP on 19.10.2026.
+//
+
+#ifndef POOL_HPP
+#define POOL_HPP
+#include <type_traits>
+#include "buffered.hpp"
+#include "component.hpp"
+#include "stable.hpp"
+#include "traits.hpp"
+
+namespace ecs {
+    namespace detail {
+        template<typename T, typename Config>
+        struct pool_selector {
+            static_assert(!(pointer_stable<T>() && double_buffered<T>()),
+                          "a component can not be pointer stable and double buffered at once");
+
+            // Tags have no values, their storage is already stable and has nothing to buffer
+            using type = std::conditional_t<
+                    std::is_empty_v<T>, component<T, typename Config::layout_type>,
+                    std::conditional_t<pointer_stable<T>(), stable_component<T, Config>,
+                                       std::conditional_t<double_buffered<T>(), buffered_component<T, Config>,
+                                                          component<T, typename Config::layout_type>>>>;
+        };
+    } // namespace detail
+
+    // Pool type a world with the given configuration uses for T
+    template<typename T, typename Config>
+    using pool_type = typename detail::pool_selector<T, Config>::type;
+} // namespace ecs
+#endif // POOL_HPP
@@ -0,0 +1,95 @@
+//
+// Created by HP on 19.10.2026.
+//
+
+#ifndef PREFAB_HPP
+#define PREFAB_HPP
+#include <algorithm>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+#include "config.hpp"
+#include "error.hpp"
+#include "type_index.hpp"
+#include "types.hpp"
+
+namespace ecs {
+    template<typename Config>
+    class basic_ecs;
+
+    /**
+     * Prototype of an entity, a set of component values which is copied to every instance.
+     * Copies of a prefab share their component values.
+     */
+    template<typename Config>
+    class basic_prefab {
+    public:
+        using entity_type = typename Config::entity_type;
+        using world_type = basic_ecs<Config>;
+
+    private:
+        class base_entry {
+        public:
+            virtual ~base_entry() = default;
+            virtual error apply(world_type &ecs, std::span<entity_type const> entities) const = 0;
+        };
+
+        template<typename T>
+        class entry : public base_entry {
+        private:
+            T m_value;
+
+        public:
+            explicit entry(T value) : m_value{std::move(value)} {}
+            error apply(world_type &ecs, std::span<entity_type const> entities) const override;
+        };
+
+        std::vector<std::pair<type_id_t, std::shared_ptr<base_entry const>>> m_entries{};
+
+    public:
+        basic_prefab() = default;
+
+        /**
+         * @brief Sets the value of component T for all instances, replaces a previous value of the same type.
+         *
+         * @return The prefab for chaining.
+         */
+        template<typename T>
+        basic_prefab &set(T value) {
+            auto entry_ptr = std::make_shared<entry<T> const>(std::move(value));
+            auto const id = type_id<T>();
+            auto const it = std::find_if(m_entries.begin(), m_entries.end(),
+                                         [id](auto const &existing) { return existing.first == id; });
+            if (it != m_entries.end()) {
+                it->second = std::move(entry_ptr);
+            } else {
+                m_entries.emplace_back(id, std::move(entry_ptr));
+            }
+            return *this;
+        }
+
+        template<typename T>
+        [[nodiscard]] bool contains() const {
+            auto const id = type_id<T>();
+            return std::any_of(m_entries.begin(), m_entries.end(),
+                               [id](auto const &existing) { return existing.first == id; });
+        }
+
+        // Number of component types
+        [[nodiscard]] std::size_t size() const { return m_entries.size(); }
+
+        // Adds all components to the given entities, one bulk write per component pool
+        error apply(world_type &ecs, std::span<entity_type const> entities) const {
+            for (auto const &[id, entry]: m_entries) {
+                if (auto const err = entry->apply(ecs, entities); err != error::ok) {
+                    return err;
+                }
+            }
+            return error::ok;
+        }
+    };
+
+    using prefab = basic_prefab<default_config>;
+} // namespace ecs
+#endif // PREFAB_HPP
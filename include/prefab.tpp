@@ -0,0 +1,14 @@
+#ifndef PREFAB_TPP
+#define PREFAB_TPP
+
+namespace ecs {
+
+    template<typename Config>
+    template<typename T>
+    error basic_prefab<Config>::entry<T>::apply(world_type &ecs, std::span<entity_type const> entities) const {
+        return ecs.insert_bulk(entities, m_value);
+    }
+} // namespace ecs
+
+
+#endif
@@ -0,0 +1,164 @@
+//
+// Created by HP on 19.10.2026.
+//
+
+#ifndef QUERY_HPP
+#define QUERY_HPP
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "config.hpp"
+#include "trace.hpp"
+#include "type_index.hpp"
+
+namespace ecs {
+    template<typename Config>
+    class basic_ecs;
+
+    /**
+     * Entities matching a set of included and excluded component types. The world keeps the set up to date on every
+     * structural change, all query handles with the same signature share one storage.
+     */
+    template<typename Config>
+    class basic_query_storage : public std::enable_shared_from_this<basic_query_storage<Config>> {
+    public:
+        using entity_type = typename Config::entity_type;
+
+    private:
+        static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+        std::vector<type_id_t> m_include{};
+        std::vector<type_id_t> m_exclude{};
+        std::vector<entity_type> m_dense{};
+        // Position in m_dense indexed by entity index
+        std::vector<std::size_t> m_sparse{};
+        // Epoch at which m_dense[i] started matching, tells a reused handle from the one matching before
+        std::vector<std::uint64_t> m_stamps{};
+        // Number of insertions so far, never reset
+        std::uint64_t m_epoch{};
+
+    public:
+        basic_query_storage(std::vector<type_id_t> include, std::vector<type_id_t> exclude) :
+            m_include{std::move(include)}, m_exclude{std::move(exclude)} {}
+
+        [[nodiscard]] std::vector<type_id_t> const &include() const noexcept { return m_include; }
+        [[nodiscard]] std::vector<type_id_t> const &exclude() const noexcept { return m_exclude; }
+
+        [[nodiscard]] bool contains(entity_type e) const noexcept {
+            auto const index = Config::to_index(e);
+            return index < m_sparse.size() && m_sparse[index] != npos && m_dense[m_sparse[index]] == e;
+        }
+
+        void insert(entity_type e) {
+            if (contains(e)) {
+                return;
+            }
+            auto const index = Config::to_index(e);
+            if (index >= m_sparse.size()) {
+                m_sparse.resize(static_cast<std::size_t>(index) + 1, npos);
+            }
+            m_sparse[index] = m_dense.size();
+            m_dense.push_back(e);
+            m_stamps.push_back(m_epoch++);
+        }
+
+        void remove(entity_type e) {
+            if (!contains(e)) {
+                return;
+            }
+            auto const position = m_sparse[Config::to_index(e)];
+            auto const last = m_dense.back();
+            m_dense[position] = last;
+            m_stamps[position] = m_stamps.back();
+            m_sparse[Config::to_index(last)] = position;
+            m_sparse[Config::to_index(e)] = npos;
+            m_dense.pop_back();
+            m_stamps.pop_back();
+        }
+
+        // e matches and started matching before epoch
+        [[nodiscard]] bool contains_since(entity_type e, std::uint64_t epoch) const noexcept {
+            return contains(e) && m_stamps[m_sparse[Config::to_index(e)]] < epoch;
+        }
+
+        [[nodiscard]] std::uint64_t epoch() const noexcept { return m_epoch; }
+
+        void clear() noexcept {
+            m_dense.clear();
+            m_sparse.clear();
+            m_stamps.clear();
+        }
+
+        void shrink_to_fit() {
+            while (!m_sparse.empty() && m_sparse.back() == npos) {
+                m_sparse.pop_back();
+            }
+            m_sparse.shrink_to_fit();
+            m_dense.shrink_to_fit();
+            m_stamps.shrink_to_fit();
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept { return m_dense.size(); }
+        [[nodiscard]] typename std::vector<entity_type>::const_iterator begin() const noexcept {
+            return m_dense.begin();
+        }
+        [[nodiscard]] typename std::vector<entity_type>::const_iterator end() const noexcept { return m_dense.end(); }
+    };
+
+    /**
+     * Handle to a query registered with a world. Iteration costs O(matches), there is no rebuild per use.
+     * Structural changes of the queried components while iterating invalidate the iterators.
+     */
+    template<typename Config>
+    class basic_query {
+    public:
+        using entity_type = typename Config::entity_type;
+        using world_type = basic_ecs<Config>;
+        using storage_type = basic_query_storage<Config>;
+
+    private:
+        std::shared_ptr<storage_type const> m_storage;
+        world_type *m_ecs;
+
+    public:
+        basic_query(std::shared_ptr<storage_type const> storage, world_type *ecs) :
+            m_storage{std::move(storage)}, m_ecs{ecs} {}
+
+        [[nodiscard]] bool contains(entity_type e) const noexcept { return m_storage->contains(e); }
+        // Whether e matches without interruption since the query had the given epoch, also if its index was reused
+        [[nodiscard]] bool contains_since(entity_type e, std::uint64_t epoch) const noexcept {
+            return m_storage->contains_since(e, epoch);
+        }
+        // Grows with every entity starting to match
+        [[nodiscard]] std::uint64_t epoch() const noexcept { return m_storage->epoch(); }
+        [[nodiscard]] std::size_t size() const noexcept { return m_storage->size(); }
+        [[nodiscard]] bool empty() const noexcept { return m_storage->size() == 0; }
+
+        /**
+         * @brief Invokes func for every matching entity. Components are accessed without membership checks,
+         * so they have to be included by the query. func must not add or remove components of the included or
+         * excluded types or destroy entities, the query changes with them while it is iterated. Record such changes
+         * and apply them after the loop, or use a cursor, which tolerates them.
+         *
+         * @tparam Components The types of the components passed to func.
+         * @param func Callable taking either (entity, Components&...) or (Components&...).
+         */
+        template<typename... Components, typename Func>
+        void each(Func &&func);
+
+        [[nodiscard]] typename std::vector<entity_type>::const_iterator begin() const noexcept {
+            return m_storage->begin();
+        }
+        [[nodiscard]] typename std::vector<entity_type>::const_iterator end() const noexcept {
+            return m_storage->end();
+        }
+    };
+
+    using query = basic_query<default_config>;
+} // namespace ecs
+#endif // QUERY_HPP
@@ -0,0 +1,29 @@
+#ifndef QUERY_TPP
+#define QUERY_TPP
+
+namespace ecs {
+
+    template<typename Config>
+    template<typename... Components, typename Func>
+    void basic_query<Config>::each(Func &&func) {
+        ECS_TRACE_SCOPE("ecs::query::each");
+        auto const pools = std::make_tuple(m_ecs->template get_component_ptr<detail::component_of_t<Components>>()...);
+        std::apply(
+                [this, &func](auto *...components) {
+                    if (((components == nullptr) || ...)) {
+                        return;
+                    }
+                    for (auto const e: *m_storage) {
+                        if constexpr (std::is_invocable_v<Func &, entity_type, detail::reference_of_t<Components>...>) {
+                            func(e, detail::access<Components>::get(*components, e)...);
+                        } else {
+                            func(detail::access<Components>::get(*components, e)...);
+                        }
+                    }
+                },
+                pools);
+    }
+} // namespace ecs
+
+
+#endif
@@ -0,0 +1,117 @@
+//
+// Created by HP on 19.10.2026.
+//
+
+#ifndef REDUCE_HPP
+#define REDUCE_HPP
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "thread_pool.hpp"
+
+namespace ecs {
+    struct reduce_options {
+        // Number of threads including the calling one, 0 uses the hardware concurrency
+        std::size_t threads{0};
+        // Entities per work item of view reductions, pool reductions use one storage page per work item
+        std::size_t chunk_size{1024};
+        // Reduces every chunk on its own and combines the results in chunk order, so the result does not depend on
+        // the scheduling of the threads. Otherwise threads fold chunks into one partial result each.
+        bool deterministic{false};
+        // Persistent threads to run on. Without a pool every call starts and joins its own threads, which costs
+        // tens of microseconds and dominates small per frame reductions.
+        thread_pool *pool{nullptr};
+    };
+
+    namespace detail {
+        /**
+         * Reduces chunk_count chunks on several threads. reduce_chunk(index, accumulator) folds a chunk into the
+         * accumulator and returns it, combine merges two partial results. In deterministic mode the result only
+         * depends on the chunks, not on the number of threads. The first exception thrown by a thread is rethrown
+         * after all threads finished.
+         */
+        template<typename T, typename ReduceChunk, typename Combine>
+        T parallel_reduce(std::size_t chunk_count, T identity, ReduceChunk &&reduce_chunk, Combine &&combine,
+                          reduce_options const &options) {
+            auto threads = options.threads;
+            if (threads == 0) {
+                threads = options.pool ? options.pool->size() + 1
+                                       : std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+            }
+            if (options.pool) {
+                threads = std::min(threads, options.pool->size() + 1);
+            }
+            threads = std::min(threads, chunk_count);
+            if (threads <= 1) {
+                T result = identity;
+                for (std::size_t i = 0; i < chunk_count; ++i) {
+                    // The same combine order as with several threads
+                    result = options.deterministic ? combine(std::move(result), reduce_chunk(i, identity))
+                                                   : reduce_chunk(i, std::move(result));
+                }
+                return result;
+            }
+
+            // One slot per chunk in deterministic mode, one per thread otherwise
+            std::vector<std::optional<T>> partials(options.deterministic ? chunk_count : threads);
+            std::vector<std::exception_ptr> errors(threads);
+            std::atomic<std::size_t> next_chunk{0};
+
+            auto const work = [&](std::size_t worker) {
+                try {
+                    T accumulator = identity;
+                    for (auto i = next_chunk.fetch_add(1, std::memory_order_relaxed); i < chunk_count;
+                         i = next_chunk.fetch_add(1, std::memory_order_relaxed)) {
+                        if (options.deterministic) {
+                            partials[i] = reduce_chunk(i, identity);
+                        } else {
+                            accumulator = reduce_chunk(i, std::move(accumulator));
+                        }
+                    }
+                    if (!options.deterministic) {
+                        partials[worker] = std::move(accumulator);
+                    }
+                } catch (...) {
+                    errors[worker] = std::current_exception();
+                    // Let the other threads run out of work
+                    next_chunk.store(chunk_count, std::memory_order_relaxed);
+                }
+            };
+
+            if (options.pool) {
+                options.pool->run(threads, work);
+            } else {
+                // jthreads join when leaving the scope, also if starting one of them throws
+                std::vector<std::jthread> workers;
+                workers.reserve(threads - 1);
+                try {
+                    for (std::size_t worker = 1; worker < threads; ++worker) {
+                        workers.emplace_back(work, worker);
+                    }
+                } catch (...) {
+                    next_chunk.store(chunk_count, std::memory_order_relaxed);
+                    throw;
+                }
+                work(0);
+            }
+            for (auto const &error: errors) {
+                if (error) {
+                    std::rethrow_exception(error);
+                }
+            }
+
+            for (auto &partial: partials) {
+                if (partial) {
+                    identity = combine(std::move(identity), std::move(*partial));
+                }
+            }
+            return identity;
+        }
+    } // namespace detail
+} // namespace ecs
+#endif // REDUCE_HPP
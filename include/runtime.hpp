@@ -0,0 +1,249 @@
+//
+// Created by HP on 19.10.2026.
+//
+
+#ifndef RUNTIME_HPP
+#define RUNTIME_HPP
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "component.hpp"
+#include "config.hpp"
+#include "stats.hpp"
+#include "storage.hpp"
+#include "type_index.hpp"
+
+namespace ecs {
+    /**
+     * Layout and lifetime functions of a component type defined at runtime, e.g. by a script.
+     * Without a move function values are relocated by copy followed by destroy. Without copy and move functions the
+     * bytes are copied, also on relocation, where the bytes left behind are not destroyed. A missing destroy
+     * function does nothing.
+     */
+    struct component_descriptor {
+        std::string name{};
+        std::size_t size{};
+        std::size_t alignment{alignof(std::max_align_t)};
+        // Default constructs a value at dst, nullptr if the type has no default
+        void (*construct)(void *dst){nullptr};
+        // Copy constructs a value at dst from src
+        void (*copy)(void *dst, void const *src){nullptr};
+        // Move constructs a value at dst from src, src is destroyed afterward
+        void (*move)(void *dst, void *src){nullptr};
+        void (*destroy)(void *dst){nullptr};
+    };
+
+    // Descriptor of a static type, e.g. to hand it to a scripting layer
+    template<typename T>
+    component_descriptor describe(std::string name) {
+        component_descriptor descriptor{.name = std::move(name), .size = sizeof(T), .alignment = alignof(T)};
+        if constexpr (std::is_default_constructible_v<T>) {
+            descriptor.construct = [](void *dst) { ::new (dst) T{}; };
+        }
+        if constexpr (!std::is_trivially_copyable_v<T>) {
+            descriptor.copy = [](void *dst, void const *src) { ::new (dst) T{*static_cast<T const *>(src)}; };
+            descriptor.move = [](void *dst, void *src) { ::new (dst) T{std::move(*static_cast<T *>(src))}; };
+        }
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            descriptor.destroy = [](void *dst) { static_cast<T *>(dst)->~T(); };
+        }
+        return descriptor;
+    }
+
+    /**
+     * Pool of a runtime defined component. Values are stored as raw bytes in the same dense, paged layout as
+     * component<T, MemoryLayout> and are only touched through the functions of the descriptor.
+     */
+    template<typename MemoryLayout>
+    class runtime_component final : public basic_base_component<typename MemoryLayout::config_type> {
+    public:
+        using config_type = typename MemoryLayout::config_type;
+        using entity_type = typename config_type::entity_type;
+
+    private:
+        component_descriptor m_descriptor;
+        typename config_type::raw_storage_type m_components;
+        MemoryLayout m_layout;
+        std::size_t m_adds{};
+        std::size_t m_removes{};
+        std::size_t m_swaps{};
+
+        void copy(void *dst, void const *src) const {
+            if (m_descriptor.copy) {
+                m_descriptor.copy(dst, src);
+            } else {
+                std::memcpy(dst, src, m_descriptor.size);
+            }
+        }
+
+        // Relocates src to dst, src is dead afterward
+        void relocate(void *dst, void *src) const {
+            if (m_descriptor.move) {
+                m_descriptor.move(dst, src);
+            } else if (m_descriptor.copy) {
+                m_descriptor.copy(dst, src);
+            } else {
+                // the value now lives in dst, destroying the old bytes would destroy it
+                std::memcpy(dst, src, m_descriptor.size);
+                return;
+            }
+            destroy_at(src);
+        }
+
+        void destroy_at(void *value) const {
+            if (m_descriptor.destroy) {
+                m_descriptor.destroy(value);
+            }
+        }
+
+    public:
+        // Throws std::invalid_argument if the alignment of the descriptor is not a power of two
+        explicit runtime_component(component_descriptor descriptor) :
+            m_descriptor{std::move(descriptor)}, m_components{m_descriptor.size, m_descriptor.alignment} {}
+
+        runtime_component(runtime_component const &) = delete;
+        runtime_component &operator=(runtime_component const &) = delete;
+
+        ~runtime_component() override { runtime_component::clear(); }
+
+        [[nodiscard]] component_descriptor const &descriptor() const noexcept { return m_descriptor; }
+
+        error add(entity_type e, void const *value) {
+            if (!value && !m_descriptor.construct) {
+                return error::failed;
+            }
+            auto const new_index = m_layout.add(e);
+            if (!new_index.has_value()) {
+                return new_index.error();
+            }
+            m_components.reserve(new_index.value() + 1);
+            auto *dst = m_components[new_index.value()];
+            if (value) {
+                copy(dst, value);
+            } else {
+                m_descriptor.construct(dst);
+            }
+            ++m_adds;
+            return error::ok;
+        }
+
+        error remove(entity_type e) {
+            auto const index = m_layout.get(e);
+            if (!index.has_value()) {
+                return index.error();
+            }
+            destroy_at(m_components[index.value()]);
+            m_layout.remove(e);
+            if (auto const last_index = m_layout.size(); index.value() != last_index) {
+                relocate(m_components[index.value()], m_components[last_index]);
+                ++m_swaps;
+            }
+            ++m_removes;
+            return error::ok;
+        }
+
+        [[nodiscard]] void *try_get(entity_type e) noexcept {
+            auto const index = m_layout.get(e);
+            return index.has_value() ? m_components[index.value()] : nullptr;
+        }
+
+        [[nodiscard]] void const *try_get(entity_type e) const noexcept {
+            auto const index = m_layout.get(e);
+            return index.has_value() ? m_components[index.value()] : nullptr;
+        }
+
+        error add_erased(entity_type e, void const *value) override { return add(e, value); }
+        [[nodiscard]] void *try_get_erased(entity_type e) noexcept override { return try_get(e); }
+
+        error clear() override {
+            for (std::size_t i = 0; i < size(); ++i) {
+                destroy_at(m_components[i]);
+            }
+            m_layout.clear();
+            return error::ok;
+        }
+
+        [[nodiscard]] bool contains(entity_type e) const noexcept override { return m_layout.contains(e); }
+
+        error destroy(entity_type e) override { return remove(e); }
+
+        void shrink_to_fit() override {
+            m_components.shrink(size());
+            m_layout.shrink_to_fit();
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept { return m_layout.size(); }
+
+        [[nodiscard]] pool_stats stats() const override {
+            return {
+                    .type_name = m_descriptor.name,
+                    .size = size(),
+                    .capacity = m_components.capacity(),
+                    .bytes_used = size() * m_components.stride(),
+                    .bytes_reserved = m_components.capacity() * m_components.stride(),
+                    .index_bytes = m_layout.index_bytes(),
+                    .adds = m_adds,
+                    .removes = m_removes,
+                    .swaps = m_swaps,
+            };
+        }
+    };
+
+    /**
+     * View over components addressed by type id, static and runtime registered ids can be mixed.
+     * Components are handed out as untyped pointers in the order of the included ids.
+     */
+    template<typename Config>
+    class basic_runtime_view {
+    public:
+        using entity_type = typename Config::entity_type;
+        using pool_type = basic_base_component<Config>;
+
+    private:
+        std::vector<entity_type> m_entities;
+        std::vector<type_id_t> m_ids;
+        std::vector<pool_type *> m_pools;
+
+    public:
+        basic_runtime_view(std::vector<entity_type> entities, std::vector<type_id_t> ids, std::vector<pool_type *> pools) :
+            m_entities{std::move(entities)}, m_ids{std::move(ids)}, m_pools{std::move(pools)} {}
+
+        // Returns nullptr if id is not part of the view or e does not own the component
+        [[nodiscard]] void *get(entity_type e, type_id_t id) const noexcept {
+            auto const found = std::find(m_ids.begin(), m_ids.end(), id);
+            return found == m_ids.end() ? nullptr : m_pools[found - m_ids.begin()]->try_get_erased(e);
+        }
+
+        /**
+         * @brief Invokes func for every entity in the view.
+         *
+         * @param func Callable taking (entity, std::span<void *const> components), one pointer per included id.
+         */
+        template<typename Func>
+        void each(Func &&func) const {
+            std::vector<void *> components(m_pools.size());
+            for (auto const e: m_entities) {
+                std::transform(m_pools.begin(), m_pools.end(), components.begin(),
+                               [e](pool_type *pool) { return pool->try_get_erased(e); });
+                func(e, std::span<void *const>{components});
+            }
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept { return m_entities.size(); }
+        [[nodiscard]] typename std::vector<entity_type>::const_iterator begin() const noexcept {
+            return m_entities.begin();
+        }
+        [[nodiscard]] typename std::vector<entity_type>::const_iterator end() const noexcept {
+            return m_entities.end();
+        }
+    };
+
+    using runtime_view = basic_runtime_view<default_config>;
+} // namespace ecs
+#endif // RUNTIME_HPP
@@ -0,0 +1,131 @@
+//
+// Created by HP on 19.10.2026.
+//
+
+#ifndef SPATIAL_HPP
+#define SPATIAL_HPP
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <tl/expected.hpp>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "component.hpp"
+#include "config.hpp"
+#include "error.hpp"
+#include "pool.hpp"
+
+namespace ecs {
+    using point = std::array<float, 2>;
+
+    /**
+     * Uniform grid hashing entities by the cell of their position. Only occupied cells are stored, so the grid is
+     * unbounded. Radius and box queries visit the overlapped cells, nearest neighbour queries search rings of cells
+     * around the center until no closer entity can exist.
+     */
+    template<typename Config>
+    class basic_spatial_grid {
+    public:
+        using entity_type = typename Config::entity_type;
+
+    private:
+        using cell_key = std::uint64_t;
+
+        struct record {
+            entity_type entity{Config::null};
+            point position{};
+            cell_key cell{};
+            // Position of the entity in its cell
+            std::size_t slot{};
+        };
+
+        float m_cell_size;
+        std::unordered_map<cell_key, std::vector<entity_type>> m_cells{};
+        // Indexed by entity index
+        std::vector<record> m_records{};
+        std::size_t m_size{};
+
+        [[nodiscard]] std::int32_t coordinate(float value) const noexcept;
+        [[nodiscard]] static cell_key key(std::int64_t x, std::int64_t y) noexcept;
+        [[nodiscard]] cell_key key(point const &p) const noexcept {
+            return key(coordinate(p[0]), coordinate(p[1]));
+        }
+        void link(record &r);
+        void unlink(record &r);
+
+        // Invokes func for every entity in the cells [x0, x1] x [y0, y1]
+        template<typename Func>
+        void visit(std::int64_t x0, std::int64_t y0, std::int64_t x1, std::int64_t y1, Func &&func) const;
+
+    public:
+        // Throws std::invalid_argument if cell_size is not positive
+        explicit basic_spatial_grid(float cell_size);
+
+        // Inserts e or moves it to p
+        void update(entity_type e, point const &p);
+        error remove(entity_type e);
+        void clear();
+        // Releases records and cell buckets not needed for the current entities
+        void shrink_to_fit();
+
+        [[nodiscard]] bool contains(entity_type e) const noexcept;
+        [[nodiscard]] tl::expected<point, error> position(entity_type e) const;
+        [[nodiscard]] std::size_t size() const noexcept { return m_size; }
+        [[nodiscard]] float cell_size() const noexcept { return m_cell_size; }
+
+        // Entities within distance r of center, in no particular order
+        [[nodiscard]] std::vector<entity_type> radius(point const &center, float r) const;
+        // Entities inside the box [min, max], in no particular order
+        [[nodiscard]] std::vector<entity_type> aabb(point const &min, point const &max) const;
+        // Up to k entities closest to center, nearest first
+        [[nodiscard]] std::vector<entity_type> nearest(point const &center, std::size_t k) const;
+    };
+
+    /**
+     * Spatial grid attached to a component type of a world. The world refreshes it whenever a component of that
+     * type is inserted, erased, patched or destroyed.
+     */
+    template<typename Config>
+    class basic_base_spatial_index : public basic_spatial_grid<Config> {
+    public:
+        using entity_type = typename Config::entity_type;
+        using basic_spatial_grid<Config>::basic_spatial_grid;
+
+        virtual ~basic_base_spatial_index() = default;
+        // Reads the position of e from pool, e is removed if it does not own the component
+        virtual void refresh(entity_type e, basic_base_component<Config> const &pool) = 0;
+    };
+
+    template<typename Config, typename T>
+    class basic_spatial_index final : public basic_base_spatial_index<Config> {
+    public:
+        using entity_type = typename Config::entity_type;
+        using component_type = pool_type<T, Config>;
+
+    private:
+        std::function<point(T const &)> m_position;
+
+    public:
+        basic_spatial_index(float cell_size, std::function<point(T const &)> position) :
+            basic_base_spatial_index<Config>{cell_size}, m_position{std::move(position)} {}
+
+        void refresh(entity_type e, basic_base_component<Config> const &pool) override {
+            if (auto const *value = static_cast<component_type const &>(pool).try_get(e)) {
+                this->update(e, m_position(*value));
+            } else {
+                this->remove(e);
+            }
+        }
+    };
+
+    using spatial_grid = basic_spatial_grid<default_config>;
+} // namespace ecs
+
+#include "spatial.tpp"
+
+namespace ecs {
+    extern template class basic_spatial_grid<default_config>;
+}
+#endif // SPATIAL_HPP
@@ -0,0 +1,249 @@
+#ifndef SPATIAL_TPP
+#define SPATIAL_TPP
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace ecs {
+    template<typename Config>
+    basic_spatial_grid<Config>::basic_spatial_grid(float cell_size) : m_cell_size{cell_size} {
+        if (!(cell_size > 0)) {
+            throw std::invalid_argument("cell size has to be positive");
+        }
+    }
+
+    template<typename Config>
+    std::int32_t basic_spatial_grid<Config>::coordinate(float value) const noexcept {
+        constexpr auto lowest = static_cast<double>(std::numeric_limits<std::int32_t>::min());
+        constexpr auto highest = static_cast<double>(std::numeric_limits<std::int32_t>::max());
+        auto const cell = std::floor(static_cast<double>(value) / m_cell_size);
+        return static_cast<std::int32_t>(std::clamp(cell, lowest, highest));
+    }
+
+    template<typename Config>
+    typename basic_spatial_grid<Config>::cell_key basic_spatial_grid<Config>::key(std::int64_t x,
+                                                                                  std::int64_t y) noexcept {
+        return (static_cast<cell_key>(static_cast<std::uint32_t>(x)) << 32) | static_cast<std::uint32_t>(y);
+    }
+
+    template<typename Config>
+    void basic_spatial_grid<Config>::link(record &r) {
+        auto &cell = m_cells[r.cell];
+        r.slot = cell.size();
+        cell.push_back(r.entity);
+    }
+
+    template<typename Config>
+    void basic_spatial_grid<Config>::unlink(record &r) {
+        auto const found = m_cells.find(r.cell);
+        auto &cell = found->second;
+        auto const last = cell.back();
+        cell[r.slot] = last;
+        m_records[Config::to_index(last)].slot = r.slot;
+        cell.pop_back();
+        if (cell.empty()) {
+            m_cells.erase(found);
+        }
+    }
+
+    template<typename Config>
+    template<typename Func>
+    void basic_spatial_grid<Config>::visit(std::int64_t x0, std::int64_t y0, std::int64_t x1, std::int64_t y1,
+                                           Func &&func) const {
+        auto const cells = static_cast<double>(x1 - x0 + 1) * static_cast<double>(y1 - y0 + 1);
+        if (cells > static_cast<double>(m_cells.size())) {
+            // Fewer occupied cells than cells in the range, testing every occupied cell is cheaper
+            for (auto const &[cell, entities]: m_cells) {
+                auto const x = static_cast<std::int32_t>(cell >> 32);
+                auto const y = static_cast<std::int32_t>(cell & 0xFFFFFFFF);
+                if (x >= x0 && x <= x1 && y >= y0 && y <= y1) {
+                    std::for_each(entities.begin(), entities.end(), func);
+                }
+            }
+            return;
+        }
+        for (auto x = x0; x <= x1; ++x) {
+            for (auto y = y0; y <= y1; ++y) {
+                if (auto const found = m_cells.find(key(x, y)); found != m_cells.end()) {
+                    std::for_each(found->second.begin(), found->second.end(), func);
+                }
+            }
+        }
+    }
+
+    template<typename Config>
+    void basic_spatial_grid<Config>::update(entity_type e, point const &p) {
+        auto const index = Config::to_index(e);
+        if (index >= m_records.size()) {
+            m_records.resize(static_cast<std::size_t>(index) + 1);
+        }
+        auto &r = m_records[index];
+        auto const cell = key(p);
+        if (r.entity == e && r.cell == cell) {
+            r.position = p;
+            return;
+        }
+        if (r.entity != Config::null) {
+            // Moved to another cell, or the index is still held by an older version of e
+            unlink(r);
+            --m_size;
+        }
+        r.entity = e;
+        r.position = p;
+        r.cell = cell;
+        link(r);
+        ++m_size;
+    }
+
+    template<typename Config>
+    error basic_spatial_grid<Config>::remove(entity_type e) {
+        if (!contains(e)) {
+            return error::not_found;
+        }
+        auto &r = m_records[Config::to_index(e)];
+        unlink(r);
+        r.entity = Config::null;
+        --m_size;
+        return error::ok;
+    }
+
+    template<typename Config>
+    void basic_spatial_grid<Config>::clear() {
+        m_cells.clear();
+        m_records.clear();
+        m_size = 0;
+    }
+
+    template<typename Config>
+    void basic_spatial_grid<Config>::shrink_to_fit() {
+        while (!m_records.empty() && m_records.back().entity == Config::null) {
+            m_records.pop_back();
+        }
+        m_records.shrink_to_fit();
+        for (auto &[cell, entities]: m_cells) {
+            entities.shrink_to_fit();
+        }
+        std::unordered_map<cell_key, std::vector<entity_type>>{std::make_move_iterator(m_cells.begin()),
+                                                               std::make_move_iterator(m_cells.end())}
+                .swap(m_cells);
+    }
+
+    template<typename Config>
+    bool basic_spatial_grid<Config>::contains(entity_type e) const noexcept {
+        auto const index = Config::to_index(e);
+        return e != Config::null && index < m_records.size() && m_records[index].entity == e;
+    }
+
+    template<typename Config>
+    tl::expected<point, error> basic_spatial_grid<Config>::position(entity_type e) const {
+        if (!contains(e)) {
+            return tl::unexpected(error::not_found);
+        }
+        return m_records[Config::to_index(e)].position;
+    }
+
+    template<typename Config>
+    std::vector<typename Config::entity_type> basic_spatial_grid<Config>::radius(point const &center, float r) const {
+        std::vector<entity_type> result;
+        if (r < 0) {
+            return result;
+        }
+        auto const r2 = r * r;
+        visit(coordinate(center[0] - r), coordinate(center[1] - r), coordinate(center[0] + r),
+              coordinate(center[1] + r), [&](entity_type e) {
+                  auto const &p = m_records[Config::to_index(e)].position;
+                  auto const dx = p[0] - center[0];
+                  auto const dy = p[1] - center[1];
+                  if (dx * dx + dy * dy <= r2) {
+                      result.push_back(e);
+                  }
+              });
+        return result;
+    }
+
+    template<typename Config>
+    std::vector<typename Config::entity_type> basic_spatial_grid<Config>::aabb(point const &min,
+                                                                               point const &max) const {
+        std::vector<entity_type> result;
+        visit(coordinate(min[0]), coordinate(min[1]), coordinate(max[0]), coordinate(max[1]), [&](entity_type e) {
+            auto const &p = m_records[Config::to_index(e)].position;
+            if (p[0] >= min[0] && p[0] <= max[0] && p[1] >= min[1] && p[1] <= max[1]) {
+                result.push_back(e);
+            }
+        });
+        return result;
+    }
+
+    template<typename Config>
+    std::vector<typename Config::entity_type> basic_spatial_grid<Config>::nearest(point const &center,
+                                                                                  std::size_t k) const {
+        k = std::min(k, m_size);
+        // Max heap of the k best candidates by squared distance
+        std::vector<std::pair<float, entity_type>> best;
+        best.reserve(k + 1);
+        auto const consider = [&](entity_type e) {
+            auto const &p = m_records[Config::to_index(e)].position;
+            auto const dx = p[0] - center[0];
+            auto const dy = p[1] - center[1];
+            best.emplace_back(dx * dx + dy * dy, e);
+            std::push_heap(best.begin(), best.end());
+            if (best.size() > k) {
+                std::pop_heap(best.begin(), best.end());
+                best.pop_back();
+            }
+        };
+
+        if (k > 0) {
+            std::int64_t const cx = coordinate(center[0]);
+            std::int64_t const cy = coordinate(center[1]);
+            std::size_t visited_cells = 0;
+            std::size_t seen = 0;
+            auto const visit_cell = [&](std::int64_t x, std::int64_t y) {
+                ++visited_cells;
+                if (auto const found = m_cells.find(key(x, y)); found != m_cells.end()) {
+                    seen += found->second.size();
+                    std::for_each(found->second.begin(), found->second.end(), consider);
+                }
+            };
+
+            for (std::int64_t ring = 0;; ++ring) {
+                // Entities outside the rings searched so far are at least ring - 1 cells away from center
+                auto const bound = static_cast<float>(std::max<std::int64_t>(ring - 1, 0)) * m_cell_size;
+                if (seen == m_size || (best.size() == k && best.front().first <= bound * bound)) {
+                    break;
+                }
+                if (visited_cells > m_cells.size()) {
+                    // The occupied cells are far apart, a full scan is cheaper than widening the rings
+                    best.clear();
+                    for (auto const &[cell, entities]: m_cells) {
+                        std::for_each(entities.begin(), entities.end(), consider);
+                    }
+                    break;
+                }
+                if (ring == 0) {
+                    visit_cell(cx, cy);
+                    continue;
+                }
+                for (auto x = cx - ring; x <= cx + ring; ++x) {
+                    visit_cell(x, cy - ring);
+                    visit_cell(x, cy + ring);
+                }
+                for (auto y = cy - ring + 1; y < cy + ring; ++y) {
+                    visit_cell(cx - ring, y);
+                    visit_cell(cx + ring, y);
+                }
+            }
+        }
+
+        std::sort_heap(best.begin(), best.end());
+        std::vector<entity_type> result;
+        result.reserve(best.size());
+        for (auto const &[distance, e]: best) {
+            result.push_back(e);
+        }
+        return result;
+    }
+} // namespace ecs
+
+#endif
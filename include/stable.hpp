@@ -0,0 +1,205 @@
+//
+// Created by HP on 19.10.2026.
+//
+
+#ifndef STABLE_HPP
+#define STABLE_HPP
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <typeinfo>
+#include <vector>
+#include "component.hpp"
+#include "config.hpp"
+#include "stats.hpp"
+#include "storage.hpp"
+
+namespace ecs {
+    /**
+     * Storage which never moves a component. Removing one leaves a tombstone whose slot is reused by the next add,
+     * so pointers and references stay valid until the component itself is removed. Iteration skips the tombstones.
+     */
+    template<typename T, typename Config>
+    class stable_component : public basic_base_component<Config> {
+    public:
+        using config_type = Config;
+        using entity_type = typename Config::entity_type;
+
+    private:
+        static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+        typename Config::template storage_type<T> m_components;
+        // Owner of every slot, Config::null marks a tombstone
+        std::vector<entity_type> m_owners{};
+        // Slot indexed by entity index
+        std::vector<std::size_t> m_slots{};
+        // Tombstones, the most recent one is reused first
+        std::vector<std::size_t> m_free{};
+        std::size_t m_size{};
+        std::size_t m_adds{};
+        std::size_t m_removes{};
+
+        [[nodiscard]] std::size_t slot_of(entity_type e) const noexcept {
+            auto const index = Config::to_index(e);
+            if (index >= m_slots.size()) {
+                return npos;
+            }
+            auto const slot = m_slots[index];
+            return slot != npos && m_owners[slot] == e ? slot : npos;
+        }
+
+    public:
+        error add(entity_type e, T const &c) {
+            if (slot_of(e) != npos) {
+                return error::exists;
+            }
+            if (m_size >= Config::max_entities) {
+                return error::max_entities;
+            }
+
+            std::size_t slot{};
+            if (!m_free.empty()) {
+                slot = m_free.back();
+                m_free.pop_back();
+            } else {
+                slot = m_owners.size();
+                m_components.reserve(slot + 1);
+                m_owners.push_back(Config::null);
+            }
+            auto const index = Config::to_index(e);
+            if (index >= m_slots.size()) {
+                m_slots.resize(static_cast<std::size_t>(index) + 1, npos);
+            }
+            m_components[slot] = c;
+            m_owners[slot] = e;
+            m_slots[index] = slot;
+            ++m_size;
+            ++m_adds;
+            return error::ok;
+        }
+
+        error add_bulk(std::span<entity_type const> entities, T const &c) {
+            if (m_size + entities.size() > Config::max_entities) {
+                return error::max_entities;
+            }
+            if (std::any_of(entities.begin(), entities.end(), [this](entity_type e) { return contains(e); }) ||
+                detail::has_duplicates(entities)) {
+                return error::exists;
+            }
+            for (auto const e: entities) {
+                add(e, c);
+            }
+            return error::ok;
+        }
+
+        error remove(entity_type e) {
+            auto const slot = slot_of(e);
+            if (slot == npos) {
+                return error::not_found;
+            }
+            // Release resources held by the value, the slot itself stays in place
+            m_components[slot] = T{};
+            m_owners[slot] = Config::null;
+            m_slots[Config::to_index(e)] = npos;
+            m_free.push_back(slot);
+            --m_size;
+            ++m_removes;
+            return error::ok;
+        }
+
+        T &get(entity_type e) {
+            if (auto const slot = slot_of(e); slot != npos) {
+                return m_components[slot];
+            }
+            detail::throw_entity_not_found(e);
+        }
+
+        T get(entity_type e) const {
+            if (auto const slot = slot_of(e); slot != npos) {
+                return m_components[slot];
+            }
+            detail::throw_entity_not_found(e);
+        }
+
+        T *try_get(entity_type e) noexcept {
+            auto const slot = slot_of(e);
+            return slot != npos ? &m_components[slot] : nullptr;
+        }
+
+        T const *try_get(entity_type e) const noexcept {
+            auto const slot = slot_of(e);
+            return slot != npos ? &m_components[slot] : nullptr;
+        }
+
+        T &get_unchecked(entity_type e) noexcept {
+            assert(contains(e) && "get_unchecked on an entity without the component");
+            return m_components[m_slots[Config::to_index(e)]];
+        }
+
+        error add_erased(entity_type e, void const *value) override {
+            return add(e, value ? *static_cast<T const *>(value) : T{});
+        }
+
+        [[nodiscard]] void *try_get_erased(entity_type e) noexcept override { return try_get(e); }
+
+        // Invokes func(entity, T&) for every component in slot order, tombstones are skipped
+        template<typename Func>
+        void each(Func &&func) {
+            for (std::size_t slot = 0; slot < m_owners.size(); ++slot) {
+                if (m_owners[slot] != Config::null) {
+                    func(m_owners[slot], m_components[slot]);
+                }
+            }
+        }
+
+        error clear() override {
+            m_components.fill(0, m_owners.size(), T{});
+            m_owners.clear();
+            m_slots.clear();
+            m_free.clear();
+            m_size = 0;
+            return error::ok;
+        }
+
+        [[nodiscard]] bool contains(entity_type e) const noexcept override { return slot_of(e) != npos; }
+
+        error destroy(entity_type e) override { return remove(e); }
+
+        // Only trailing tombstones can be released, live components never move
+        void shrink_to_fit() override {
+            while (!m_owners.empty() && m_owners.back() == Config::null) {
+                m_owners.pop_back();
+            }
+            std::erase_if(m_free, [this](std::size_t slot) { return slot >= m_owners.size(); });
+            while (!m_slots.empty() && m_slots.back() == npos) {
+                m_slots.pop_back();
+            }
+            m_components.shrink(m_owners.size());
+            m_owners.shrink_to_fit();
+            m_slots.shrink_to_fit();
+            m_free.shrink_to_fit();
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept { return m_size; }
+        // Number of tombstones waiting for reuse
+        [[nodiscard]] std::size_t holes() const noexcept { return m_free.size(); }
+
+        [[nodiscard]] pool_stats stats() const override {
+            return {
+                    .type_name = typeid(T).name(),
+                    .size = size(),
+                    .capacity = m_components.capacity(),
+                    .bytes_used = size() * sizeof(T),
+                    .bytes_reserved = m_components.capacity() * sizeof(T),
+                    .index_bytes = m_owners.capacity() * sizeof(entity_type) +
+                                   (m_slots.capacity() + m_free.capacity()) * sizeof(std::size_t),
+                    .adds = m_adds,
+                    .removes = m_removes,
+                    .swaps = 0,
+            };
+        }
+    };
+} // namespace ecs
+#endif // STABLE_HPP
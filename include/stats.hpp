@@ -0,0 +1,31 @@
+//
+// Created by HP on 19.10.2026.
+//
+
+#ifndef STATS_HPP
+#define STATS_HPP
+#include <cstddef>
+#include <string>
+
+namespace ecs {
+    struct pool_stats {
+        // Implementation defined name of the component type
+        std::string type_name{};
+        // Number of entities owning the component
+        std::size_t size{};
+        // Number of components the pool holds without allocating, Config::max_entities is the upper bound
+        std::size_t capacity{};
+        // Bytes occupied by live components
+        std::size_t bytes_used{};
+        // Bytes reserved for component storage
+        std::size_t bytes_reserved{};
+        // Approximate bytes used by the entity <-> index mapping
+        std::size_t index_bytes{};
+        // Structural change counters since creation
+        std::size_t adds{};
+        std::size_t removes{};
+        // Removals which relocated the last component into the freed slot
+        std::size_t swaps{};
+    };
+} // namespace ecs
+#endif // STATS_HPP
@@ -0,0 +1,136 @@
+//
+// Created by HP on 19.10.2026.
+//
+
+#ifndef STORAGE_HPP
+#define STORAGE_HPP
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <vector>
+
+namespace ecs {
+    /**
+     * Dense array split into fixed size pages. Pages are allocated on demand and never move,
+     * growing the storage keeps references to existing elements valid.
+     */
+    template<typename T, std::size_t PageSize>
+    class paged_storage {
+        static_assert(PageSize > 0 && (PageSize & (PageSize - 1)) == 0, "PageSize has to be a power of two");
+
+    private:
+        std::vector<std::unique_ptr<T[]>> m_pages{};
+
+    public:
+        static constexpr std::size_t page_size = PageSize;
+
+        paged_storage() = default;
+
+        T &operator[](std::size_t index) { return m_pages[index / PageSize][index % PageSize]; }
+        T const &operator[](std::size_t index) const { return m_pages[index / PageSize][index % PageSize]; }
+
+        // Allocates pages until size elements are available
+        void reserve(std::size_t size) {
+            while (capacity() < size) {
+                m_pages.push_back(std::make_unique<T[]>(PageSize));
+            }
+        }
+
+        // Assigns value to the elements [first, first + count), page by page
+        void fill(std::size_t first, std::size_t count, T const &value) {
+            while (count > 0) {
+                auto const offset = first % PageSize;
+                auto const chunk = std::min(count, PageSize - offset);
+                std::fill_n(m_pages[first / PageSize].get() + offset, chunk, value);
+                first += chunk;
+                count -= chunk;
+            }
+        }
+
+        // Releases the pages behind the first size elements
+        void shrink(std::size_t size) {
+            auto const pages = (size + PageSize - 1) / PageSize;
+            if (pages < m_pages.size()) {
+                m_pages.resize(pages);
+            }
+            m_pages.shrink_to_fit();
+        }
+
+        [[nodiscard]] std::size_t capacity() const { return m_pages.size() * PageSize; }
+        [[nodiscard]] std::size_t page_count() const { return m_pages.size(); }
+    };
+
+    template<std::size_t PageSize>
+    class raw_paged_storage;
+
+    // Pool and index storage backed by heap pages, the default of basic_config
+    struct paged_backend {
+        static constexpr bool reserves_address_space = false;
+
+        template<typename T, std::size_t PageSize, std::size_t MaxElements>
+        using storage = paged_storage<T, PageSize>;
+        template<std::size_t PageSize, std::size_t MaxElements>
+        using raw_storage = raw_paged_storage<PageSize>;
+        template<typename T, std::size_t MaxElements>
+        using vector = std::vector<T>;
+    };
+
+    /**
+     * Paged storage for elements whose type is only known at runtime. Pages hold PageSize elements of stride bytes
+     * and are aligned to the element alignment, the elements themselves are constructed and destroyed by the owner.
+     */
+    template<std::size_t PageSize>
+    class raw_paged_storage {
+        static_assert(PageSize > 0 && (PageSize & (PageSize - 1)) == 0, "PageSize has to be a power of two");
+
+    private:
+        struct page_deleter {
+            std::size_t alignment{};
+            void operator()(std::byte *page) const { ::operator delete[](page, std::align_val_t{alignment}); }
+        };
+
+        std::vector<std::unique_ptr<std::byte[], page_deleter>> m_pages{};
+        std::size_t m_stride;
+        std::size_t m_alignment;
+
+    public:
+        static constexpr std::size_t page_size = PageSize;
+
+        // Throws std::invalid_argument if alignment is not a power of two
+        raw_paged_storage(std::size_t size, std::size_t alignment) : m_alignment{alignment} {
+            if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+                throw std::invalid_argument("alignment has to be a power of two");
+            }
+            m_stride = (std::max<std::size_t>(size, 1) + alignment - 1) / alignment * alignment;
+        }
+
+        void *operator[](std::size_t index) { return m_pages[index / PageSize].get() + index % PageSize * m_stride; }
+        void const *operator[](std::size_t index) const {
+            return m_pages[index / PageSize].get() + index % PageSize * m_stride;
+        }
+
+        // Allocates pages until size elements are available
+        void reserve(std::size_t size) {
+            while (capacity() < size) {
+                auto *page = static_cast<std::byte *>(::operator new[](PageSize * m_stride, std::align_val_t{m_alignment}));
+                m_pages.emplace_back(page, page_deleter{m_alignment});
+            }
+        }
+
+        // Releases the pages behind the first size elements
+        void shrink(std::size_t size) {
+            auto const pages = (size + PageSize - 1) / PageSize;
+            if (pages < m_pages.size()) {
+                m_pages.resize(pages);
+            }
+            m_pages.shrink_to_fit();
+        }
+
+        [[nodiscard]] std::size_t stride() const { return m_stride; }
+        [[nodiscard]] std::size_t capacity() const { return m_pages.size() * PageSize; }
+        [[nodiscard]] std::size_t page_count() const { return m_pages.size(); }
+    };
+} // namespace ecs
+#endif // STORAGE_HPP
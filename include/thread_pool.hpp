@@ -0,0 +1,56 @@
+//
+// Created by HP on 19.10.2026.
+//
+
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ecs {
+    /**
+     * Threads kept alive between parallel algorithms, so per frame systems do not start and join threads on every
+     * call. A pool runs one task at a time, tasks must not start another task on the same pool.
+     */
+    class thread_pool {
+    private:
+        // Serializes run calls from different threads
+        std::mutex m_run_mutex{};
+        std::mutex m_mutex{};
+        std::condition_variable m_wake{};
+        std::condition_variable m_done{};
+        std::function<void(std::size_t)> const *m_task{nullptr};
+        std::exception_ptr m_error{};
+        std::size_t m_generation{};
+        std::size_t m_workers{};
+        std::size_t m_pending{};
+        bool m_stop{false};
+        // Declared last, so the threads are joined before the state they use is destroyed
+        std::vector<std::jthread> m_threads{};
+
+        void work(std::size_t thread);
+        void stop() noexcept;
+
+    public:
+        // Starts threads, 0 starts one less than the hardware concurrency since the caller of run takes part
+        explicit thread_pool(std::size_t threads = 0);
+        thread_pool(thread_pool const &) = delete;
+        thread_pool &operator=(thread_pool const &) = delete;
+        ~thread_pool();
+
+        /**
+         * Invokes task(worker) for every worker in [0, workers), worker 0 on the calling thread, and returns when
+         * all of them finished. The first exception thrown by a worker is rethrown.
+         */
+        void run(std::size_t workers, std::function<void(std::size_t)> const &task);
+
+        // Number of pool threads, the calling thread of run is not counted
+        [[nodiscard]] std::size_t size() const noexcept { return m_threads.size(); }
+    };
+} // namespace ecs
+#endif // THREAD_POOL_HPP
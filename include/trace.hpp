@@ -0,0 +1,64 @@
+//
+// Created by HP on 19.10.2026.
+//
+
+#ifndef TRACE_HPP
+#define TRACE_HPP
+#include <atomic>
+
+namespace ecs::trace {
+    using hook = void (*)(char const *name);
+
+    struct hooks {
+        // Called when a traced scope is entered
+        hook begin{nullptr};
+        // Called when a traced scope is left
+        hook end{nullptr};
+    };
+
+    namespace detail {
+        inline std::atomic<hook> begin_hook{nullptr};
+        inline std::atomic<hook> end_hook{nullptr};
+    } // namespace detail
+
+    /**
+     * @brief Routes traced scopes into user provided callbacks, e.g. a profiler.
+     *
+     * Scopes are only emitted if the library is compiled with ECS_ENABLE_TRACING,
+     * otherwise all trace points compile to nothing.
+     *
+     * @param hooks The callbacks to install, nullptr disables a callback.
+     */
+    inline void set_hooks(hooks const &hooks) {
+        detail::begin_hook.store(hooks.begin, std::memory_order_release);
+        detail::end_hook.store(hooks.end, std::memory_order_release);
+    }
+
+    class scope {
+    private:
+        char const *m_name;
+
+    public:
+        explicit scope(char const *name) : m_name{name} {
+            if (auto const begin = detail::begin_hook.load(std::memory_order_acquire)) {
+                begin(m_name);
+            }
+        }
+        ~scope() {
+            if (auto const end = detail::end_hook.load(std::memory_order_acquire)) {
+                end(m_name);
+            }
+        }
+
+        scope(scope const &) = delete;
+        scope &operator=(scope const &) = delete;
+    };
+} // namespace ecs::trace
+
+#ifdef ECS_ENABLE_TRACING
+#define ECS_TRACE_SCOPE(name) ::ecs::trace::scope const ecs_trace_scope { name }
+#else
+#define ECS_TRACE_SCOPE(name) static_cast<void>(0)
+#endif
+
+#endif // TRACE_HPP
@@ -0,0 +1,42 @@
+//
+// Created by HP on 19.10.2026.
+//
+
+#ifndef TRAITS_HPP
+#define TRAITS_HPP
+
+namespace ecs {
+    /**
+     * Per type storage options, at most one of them may be enabled. An option is enabled by declaring a
+     * static constexpr bool member of the same name in the component type, or by specializing component_traits.
+     *  - pointer_stable:  components never move, removal leaves a tombstone
+     *  - double_buffered: components have a previous and a next value, see basic_ecs::swap_buffers
+     */
+    template<typename T>
+    struct component_traits {};
+
+    namespace detail {
+        template<typename T>
+        constexpr bool pointer_stable() {
+            if constexpr (requires { component_traits<T>::pointer_stable; }) {
+                return component_traits<T>::pointer_stable;
+            } else if constexpr (requires { T::pointer_stable; }) {
+                return T::pointer_stable;
+            } else {
+                return false;
+            }
+        }
+
+        template<typename T>
+        constexpr bool double_buffered() {
+            if constexpr (requires { component_traits<T>::double_buffered; }) {
+                return component_traits<T>::double_buffered;
+            } else if constexpr (requires { T::double_buffered; }) {
+                return T::double_buffered;
+            } else {
+                return false;
+            }
+        }
+    } // namespace detail
+} // namespace ecs
+#endif // TRAITS_HPP
@@ -0,0 +1,36 @@
+//
+// Created by HP on 19.10.2026.
+//
+
+#ifndef TYPE_INDEX_HPP
+#define TYPE_INDEX_HPP
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+namespace ecs {
+    using type_id_t = std::size_t;
+
+    namespace detail {
+        inline type_id_t next_type_id() {
+            static std::atomic<type_id_t> counter{};
+            return counter.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        template<typename T>
+        type_id_t type_id() {
+            static type_id_t const id = next_type_id();
+            return id;
+        }
+    } // namespace detail
+
+    /**
+     * @brief Dense, process wide id of a type. Ids are assigned on first use and start at zero,
+     * which makes them usable as index into plain arrays.
+     */
+    template<typename T>
+    type_id_t type_id() {
+        return detail::type_id<std::remove_cvref_t<T>>();
+    }
+} // namespace ecs
+#endif // TYPE_INDEX_HPP
@@ -6,8 +6,12 @@
 #define TYPES_HPP
 
 #include <cstdint>
+#include <limits>
 
 namespace ecs {
     using entity = std::uint32_t;
-}
+
+    // Marks the absence of an entity, e.g. a root without parent
+    constexpr entity null_entity = std::numeric_limits<entity>::max();
+} // namespace ecs
 #endif // TYPES_HPP
@@ -6,26 +6,49 @@
 #define VIEW_HPP
 #include <memory>
 #include <tl/expected.hpp>
+#include <tuple>
+#include <type_traits>
 #include <unordered_set>
+#include "config.hpp"
+#include "error.hpp"
+#include "reduce.hpp"
+#include "trace.hpp"
 #include "types.hpp"
 namespace ecs {
-    class ecs;
+    template<typename Config>
+    class basic_ecs;
+
+    // Lists component types an entity must not own to be part of a view
+    template<typename... Components>
+    struct exclude_t {
+        explicit constexpr exclude_t() = default;
+    };
+
+    template<typename... Components>
+    inline constexpr exclude_t<Components...> exclude{};
+
+    template<typename Config>
+    class basic_view {
+    public:
+        using entity_type = typename Config::entity_type;
+        using world_type = basic_ecs<Config>;
 
-    class view {
     private:
-        std::unordered_set<entity> m_entities{};
-        ecs *m_ecs{nullptr};
+        std::unordered_set<entity_type> m_entities{};
+        world_type *m_ecs{nullptr};
 
-        explicit view(std::unordered_set<entity> const &entities, ecs *ecs) : m_entities{entities}, m_ecs{ecs} {}
+        explicit basic_view(std::unordered_set<entity_type> const &entities, world_type *ecs) :
+            m_entities{entities}, m_ecs{ecs} {}
 
     public:
-        view() = delete;
-        view &operator=(view const &) = delete;
-        view(view const &) = delete;
+        basic_view() = delete;
+        basic_view &operator=(basic_view const &) = delete;
+        basic_view(basic_view const &) = delete;
 
-        view(view &&other) noexcept : m_entities(std::exchange(other.m_entities, {})), m_ecs(other.m_ecs) {}
+        basic_view(basic_view &&other) noexcept :
+            m_entities(std::exchange(other.m_entities, {})), m_ecs(other.m_ecs) {}
 
-        view &operator=(view &&other) noexcept {
+        basic_view &operator=(basic_view &&other) noexcept {
             if (this == std::addressof(other)) {
                 return *this;
             }
@@ -35,24 +58,72 @@ namespace ecs {
             return *this;
         }
 
-        static tl::expected<view, error> create_view(std::unordered_set<entity> const &entities, ecs *ecs) {
+        static tl::expected<basic_view, error> create_view(std::unordered_set<entity_type> const &entities,
+                                                           world_type *ecs) {
             if (!ecs) {
                 return tl::unexpected(error::failed);
             }
-            return view{entities, ecs};
+            return basic_view{entities, ecs};
         }
 
         template<typename T>
-        T &get(entity e);
+        T &get(entity_type e);
 
         template<typename... Components>
-        std::tuple<Components &...> get_multiple(entity e);
+        std::tuple<Components &...> get_multiple(entity_type e);
+
+        /**
+         * @brief Invokes func for every entity in the view. Components are accessed without membership checks,
+         * so they have to be part of the view. func must not add or remove components of the viewed types or
+         * destroy entities, a component removed from a later entity is undefined behaviour (asserted in debug
+         * builds). Record such changes and apply them after the loop, or use a cursor.
+         *
+         * @tparam Components The types of the components passed to func.
+         * @param func Callable taking either (entity, Components&...) or (Components&...).
+         */
+        template<typename... Components, typename Func>
+        void each(Func &&func);
 
-        std::unordered_set<entity>::iterator begin() { return m_entities.begin(); }
-        std::unordered_set<entity>::iterator end() { return m_entities.end(); }
+        /**
+         * @brief Transforms the components of every entity and reduces the results on several threads. The dense
+         * entity array of the first component is split into chunks of options.chunk_size and filtered by the view,
+         * transform is called concurrently for different entities. Pass a thread_pool in the options to avoid
+         * starting threads on every call.
+         *
+         * @tparam Components The types of the components passed to transform.
+         * @param identity Neutral element of reduce, every partial result starts with it.
+         * @param reduce Associative callable combining two results, e.g. std::plus<>.
+         * @param transform Callable taking either (entity, Components&...) or (Components&...), returns a result.
+         * @param options Number of threads, chunk size and whether the combine order is fixed.
+         * @return The reduced result, identity if the view is empty.
+         */
+        template<typename... Components, typename T, typename Reduce, typename Transform>
+        T transform_reduce(T identity, Reduce &&reduce, Transform &&transform, reduce_options const &options = {});
 
-        [[nodiscard]] std::unordered_set<entity>::const_iterator begin() const { return m_entities.begin(); }
-        [[nodiscard]] std::unordered_set<entity>::const_iterator end() const { return m_entities.end(); }
+        /**
+         * @brief Reduces the components of type T of every entity on several threads.
+         *
+         * @tparam T The type of the components to reduce.
+         * @param identity Neutral element of reduce.
+         * @param reduce Associative callable combining two components.
+         * @param options Number of threads, chunk size and whether the combine order is fixed.
+         * @return The reduced component, identity if the view is empty.
+         */
+        template<typename T, typename Reduce>
+        T reduce(T identity, Reduce &&reduce, reduce_options const &options = {}) {
+            return transform_reduce<T>(std::move(identity), std::forward<Reduce>(reduce),
+                                       [](T const &component) { return component; }, options);
+        }
+
+        typename std::unordered_set<entity_type>::iterator begin() { return m_entities.begin(); }
+        typename std::unordered_set<entity_type>::iterator end() { return m_entities.end(); }
+
+        [[nodiscard]] typename std::unordered_set<entity_type>::const_iterator begin() const {
+            return m_entities.begin();
+        }
+        [[nodiscard]] typename std::unordered_set<entity_type>::const_iterator end() const { return m_entities.end(); }
     };
+
+    using view = basic_view<default_config>;
 } // namespace ecs
 #endif // VIEW_HPP
@@ -2,19 +2,110 @@
 #define VIEW_TPP
 
 namespace ecs {
+    namespace detail {
+        // True if the first pool of the tuple stores its entities in a dense array
+        template<typename Pools>
+        struct leads_with_dense : std::false_type {};
 
+        template<typename Pool, typename... Pools>
+        struct leads_with_dense<std::tuple<Pool *, Pools...>>
+            : std::bool_constant<requires(Pool const &pool) { pool.entities(); }> {};
+    } // namespace detail
+
+    template<typename Config>
     template<typename T>
-    T &view::get(entity e) {
+    T &basic_view<Config>::get(entity_type e) {
         if (!m_entities.contains(e)) {
             throw std::out_of_range(std::format("entity {} not in view", static_cast<int>(e)));
         }
-        return m_ecs->get<T>(e);
+        return m_ecs->template get<T>(e);
     }
 
+    template<typename Config>
     template<typename... Components>
-    std::tuple<Components &...> view::get_multiple(entity e) {
+    std::tuple<Components &...> basic_view<Config>::get_multiple(entity_type e) {
         return {get<Components>(e)...};
     }
+
+    template<typename Config>
+    template<typename... Components, typename Func>
+    void basic_view<Config>::each(Func &&func) {
+        ECS_TRACE_SCOPE("ecs::view::each");
+        // pools are looked up once, membership is proven by the view so access needs no checks
+        auto const pools = std::make_tuple(m_ecs->template get_component_ptr<detail::component_of_t<Components>>()...);
+        std::apply(
+                [this, &func](auto *...components) {
+                    if (((components == nullptr) || ...)) {
+                        return;
+                    }
+                    for (auto const e: m_entities) {
+                        if constexpr (std::is_invocable_v<Func &, entity_type, detail::reference_of_t<Components>...>) {
+                            func(e, detail::access<Components>::get(*components, e)...);
+                        } else {
+                            func(detail::access<Components>::get(*components, e)...);
+                        }
+                    }
+                },
+                pools);
+    }
+
+    template<typename Config>
+    template<typename... Components, typename T, typename Reduce, typename Transform>
+    T basic_view<Config>::transform_reduce(T identity, Reduce &&reduce, Transform &&transform,
+                                           reduce_options const &options) {
+        ECS_TRACE_SCOPE("ecs::view::transform_reduce");
+        auto const pools = std::make_tuple(m_ecs->template get_component_ptr<detail::component_of_t<Components>>()...);
+        if (std::apply([](auto *...components) { return ((components == nullptr) || ...); }, pools)) {
+            return identity;
+        }
+
+        auto const accumulate = [&](entity_type e, T accumulator) -> T {
+            return std::apply(
+                    [&](auto *...components) -> T {
+                        if constexpr (std::is_invocable_v<Transform &, entity_type,
+                                                          detail::reference_of_t<Components>...>) {
+                            return reduce(std::move(accumulator),
+                                          transform(e, detail::access<Components>::get(*components, e)...));
+                        } else {
+                            return reduce(std::move(accumulator),
+                                          transform(detail::access<Components>::get(*components, e)...));
+                        }
+                    },
+                    pools);
+        };
+        auto const chunk_size = std::max<std::size_t>(options.chunk_size, 1);
+
+        // every entity of the view owns the first component, so the dense array of its pool is split into chunks
+        // and filtered by the view, nothing is copied and the components are visited in storage order
+        if constexpr (detail::leads_with_dense<std::remove_const_t<decltype(pools)>>::value) {
+            auto const dense = std::get<0>(pools)->entities();
+            auto const reduce_chunk = [&](std::size_t index, T accumulator) -> T {
+                auto const last = std::min((index + 1) * chunk_size, dense.size());
+                for (auto i = index * chunk_size; i < last; ++i) {
+                    if (m_entities.contains(dense[i])) {
+                        accumulator = accumulate(dense[i], std::move(accumulator));
+                    }
+                }
+                return accumulator;
+            };
+            auto const chunk_count = (dense.size() + chunk_size - 1) / chunk_size;
+            return detail::parallel_reduce(chunk_count, std::move(identity), reduce_chunk, reduce, options);
+        } else {
+            // tags and pointer stable pools have no dense array, the buckets of the view are split instead
+            auto const buckets = m_entities.bucket_count();
+            auto const reduce_chunk = [&](std::size_t index, T accumulator) -> T {
+                auto const last = std::min((index + 1) * chunk_size, buckets);
+                for (auto bucket = index * chunk_size; bucket < last; ++bucket) {
+                    for (auto it = m_entities.begin(bucket); it != m_entities.end(bucket); ++it) {
+                        accumulator = accumulate(*it, std::move(accumulator));
+                    }
+                }
+                return accumulator;
+            };
+            auto const chunk_count = (buckets + chunk_size - 1) / chunk_size;
+            return detail::parallel_reduce(chunk_count, std::move(identity), reduce_chunk, reduce, options);
+        }
+    }
 } // namespace ecs
 
 
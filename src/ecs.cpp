@@ -5,4 +5,6 @@
 #include <format>
 std::string hello(std::string const &name) { return std::format("Hello {}", name); }
 
-ecs::entity ecs::ecs::create() { return m_entities.create(); }
+namespace ecs {
+    template class basic_ecs<default_config>;
+} // namespace ecs
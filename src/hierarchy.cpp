@@ -0,0 +1,8 @@
+//
+// Created by HP on 19.10.2026.
+//
+#include "hierarchy.hpp"
+
+namespace ecs {
+    template class basic_hierarchy<default_config>;
+} // namespace ecs
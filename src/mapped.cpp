@@ -0,0 +1,204 @@
+//
+// Created by HP on 19.10.2026.
+//
+#include "mapped.hpp"
+#include <cerrno>
+#include <system_error>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ecs {
+    namespace {
+        std::size_t system_page_size() {
+#ifdef _WIN32
+            SYSTEM_INFO info;
+            GetSystemInfo(&info);
+            return info.dwPageSize;
+#else
+            return static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#endif
+        }
+
+        constexpr std::size_t huge_page_size = std::size_t{2} << 20;
+
+        std::size_t round_up(std::size_t bytes, std::size_t granularity) {
+            return (bytes + granularity - 1) / granularity * granularity;
+        }
+    } // namespace
+
+    mapped_region::mapped_region(std::size_t bytes, huge_pages huge) : m_granularity{system_page_size()} {
+        m_size = round_up(bytes == 0 ? 1 : bytes, m_granularity);
+#ifdef _WIN32
+        // Large pages need a privilege and have to be committed at once, so they are not used
+        static_cast<void>(huge);
+        m_data = static_cast<std::byte *>(VirtualAlloc(nullptr, m_size, MEM_RESERVE, PAGE_NOACCESS));
+#else
+        void *data = MAP_FAILED;
+#ifdef MAP_HUGETLB
+        if (huge == huge_pages::hugetlb) {
+            // Without MAP_NORESERVE the huge pages are reserved now, an empty pool fails here instead of on access
+            auto const size = round_up(m_size, huge_page_size);
+            data = mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (data != MAP_FAILED) {
+                m_size = size;
+                m_granularity = huge_page_size;
+            }
+        }
+#endif
+        if (data == MAP_FAILED) {
+            data = mmap(nullptr, m_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        }
+        if (data == MAP_FAILED) {
+            data = nullptr;
+        }
+#ifdef MADV_HUGEPAGE
+        if (data && huge == huge_pages::transparent) {
+            madvise(data, m_size, MADV_HUGEPAGE);
+        }
+#endif
+        m_data = static_cast<std::byte *>(data);
+#endif
+        if (!m_data) {
+            throw std::bad_alloc{};
+        }
+    }
+
+    mapped_region::mapped_region(std::filesystem::path const &path, std::size_t bytes) :
+        m_granularity{system_page_size()}, m_file_backed{true} {
+        m_size = round_up(bytes == 0 ? 1 : bytes, m_granularity);
+#ifdef _WIN32
+        auto const file = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, OPEN_ALWAYS,
+                                      FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            throw std::system_error(static_cast<int>(GetLastError()), std::system_category(), "could not open file");
+        }
+        auto const size = static_cast<unsigned long long>(m_size);
+        // The mapping grows the file to size if it is smaller
+        auto const mapping = CreateFileMappingW(file, nullptr, PAGE_READWRITE, static_cast<DWORD>(size >> 32),
+                                                static_cast<DWORD>(size & 0xFFFFFFFF), nullptr);
+        CloseHandle(file);
+        if (!mapping) {
+            throw std::system_error(static_cast<int>(GetLastError()), std::system_category(), "could not map file");
+        }
+        m_data = static_cast<std::byte *>(MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, m_size));
+        CloseHandle(mapping);
+        if (!m_data) {
+            throw std::system_error(static_cast<int>(GetLastError()), std::system_category(), "could not map file");
+        }
+#else
+        auto const file = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (file < 0) {
+            throw std::system_error(errno, std::generic_category(), "could not open file");
+        }
+        struct stat status{};
+        if (fstat(file, &status) != 0 ||
+            (static_cast<std::size_t>(status.st_size) < m_size && ftruncate(file, static_cast<off_t>(m_size)) != 0)) {
+            auto const err = errno;
+            close(file);
+            throw std::system_error(err, std::generic_category(), "could not resize file");
+        }
+        void *data = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+        auto const err = errno;
+        close(file);
+        if (data == MAP_FAILED) {
+            throw std::system_error(err, std::generic_category(), "could not map file");
+        }
+        m_data = static_cast<std::byte *>(data);
+#endif
+        // Pages of the file are loaded by the system on first access
+        m_committed = m_size;
+    }
+
+    mapped_region::mapped_region(mapped_region &&other) noexcept :
+        m_data{std::exchange(other.m_data, nullptr)}, m_size{std::exchange(other.m_size, 0)},
+        m_committed{std::exchange(other.m_committed, 0)}, m_granularity{other.m_granularity},
+        m_file_backed{other.m_file_backed} {}
+
+    mapped_region &mapped_region::operator=(mapped_region &&other) noexcept {
+        if (this != &other) {
+            release();
+            m_data = std::exchange(other.m_data, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+            m_committed = std::exchange(other.m_committed, 0);
+            m_granularity = other.m_granularity;
+            m_file_backed = other.m_file_backed;
+        }
+        return *this;
+    }
+
+    mapped_region::~mapped_region() { release(); }
+
+    void mapped_region::release() noexcept {
+        if (!m_data) {
+            return;
+        }
+#ifdef _WIN32
+        if (m_file_backed) {
+            UnmapViewOfFile(m_data);
+        } else {
+            VirtualFree(m_data, 0, MEM_RELEASE);
+        }
+#else
+        munmap(m_data, m_size);
+#endif
+        m_data = nullptr;
+    }
+
+    void mapped_region::commit(std::size_t bytes) {
+        if (bytes <= m_committed) {
+            return;
+        }
+        auto const end = round_up(bytes, m_granularity);
+        if (end > m_size) {
+            throw std::bad_alloc{};
+        }
+#ifdef _WIN32
+        auto const ok = VirtualAlloc(m_data + m_committed, end - m_committed, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+#else
+        auto const ok = mprotect(m_data + m_committed, end - m_committed, PROT_READ | PROT_WRITE) == 0;
+#endif
+        if (!ok) {
+            throw std::bad_alloc{};
+        }
+        m_committed = end;
+    }
+
+    void mapped_region::decommit(std::size_t bytes) noexcept {
+        auto const begin = round_up(bytes, m_granularity);
+        if (m_file_backed || begin >= m_committed) {
+            return;
+        }
+#ifdef _WIN32
+        VirtualFree(m_data + begin, m_committed - begin, MEM_DECOMMIT);
+#else
+        madvise(m_data + begin, m_committed - begin, MADV_DONTNEED);
+        mprotect(m_data + begin, m_committed - begin, PROT_NONE);
+#endif
+        m_committed = begin;
+    }
+
+    void mapped_region::flush() noexcept {
+        if (!m_file_backed || !m_data) {
+            return;
+        }
+#ifdef _WIN32
+        FlushViewOfFile(m_data, 0);
+#else
+        msync(m_data, m_size, MS_SYNC);
+#endif
+    }
+} // namespace ecs
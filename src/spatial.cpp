@@ -0,0 +1,8 @@
+//
+// Created by HP on 19.10.2026.
+//
+#include "spatial.hpp"
+
+namespace ecs {
+    template class basic_spatial_grid<default_config>;
+} // namespace ecs
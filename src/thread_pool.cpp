@@ -0,0 +1,107 @@
+//
+// Created by HP on 19.10.2026.
+//
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace ecs {
+    thread_pool::thread_pool(std::size_t threads) {
+        if (threads == 0) {
+            threads = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+        }
+        m_threads.reserve(threads);
+        try {
+            for (std::size_t thread = 0; thread < threads; ++thread) {
+                m_threads.emplace_back([this, thread] { work(thread); });
+            }
+        } catch (...) {
+            // the started threads have to leave their loop before they are joined
+            stop();
+            m_threads.clear();
+            throw;
+        }
+    }
+
+    thread_pool::~thread_pool() {
+        stop();
+        m_threads.clear();
+    }
+
+    void thread_pool::stop() noexcept {
+        {
+            std::scoped_lock lock{m_mutex};
+            m_stop = true;
+        }
+        m_wake.notify_all();
+    }
+
+    void thread_pool::work(std::size_t thread) {
+        std::size_t seen{};
+        while (true) {
+            std::function<void(std::size_t)> const *task{};
+            {
+                std::unique_lock lock{m_mutex};
+                m_wake.wait(lock, [this, seen] { return m_stop || m_generation != seen; });
+                if (m_stop) {
+                    return;
+                }
+                seen = m_generation;
+                // pool thread i runs worker i + 1, worker 0 is the caller
+                if (thread + 1 >= m_workers) {
+                    continue;
+                }
+                task = m_task;
+            }
+
+            std::exception_ptr error{};
+            try {
+                (*task)(thread + 1);
+            } catch (...) {
+                error = std::current_exception();
+            }
+
+            std::scoped_lock lock{m_mutex};
+            if (error && !m_error) {
+                m_error = error;
+            }
+            if (--m_pending == 0) {
+                m_done.notify_one();
+            }
+        }
+    }
+
+    void thread_pool::run(std::size_t workers, std::function<void(std::size_t)> const &task) {
+        std::scoped_lock run_lock{m_run_mutex};
+        workers = std::min(workers, m_threads.size() + 1);
+        {
+            std::scoped_lock lock{m_mutex};
+            m_task = &task;
+            m_workers = workers;
+            m_pending = workers > 0 ? workers - 1 : 0;
+            m_error = nullptr;
+            ++m_generation;
+        }
+        m_wake.notify_all();
+
+        std::exception_ptr error{};
+        if (workers > 0) {
+            try {
+                task(0);
+            } catch (...) {
+                error = std::current_exception();
+            }
+        }
+
+        std::unique_lock lock{m_mutex};
+        m_done.wait(lock, [this] { return m_pending == 0; });
+        m_task = nullptr;
+        if (!error) {
+            error = std::exchange(m_error, nullptr);
+        }
+        lock.unlock();
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+} // namespace ecs
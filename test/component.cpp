@@ -2,9 +2,13 @@
 // Created by HP on 27.09.2024.
 //
 #include "component.hpp"
+#include <array>
 #include <catch2/catch_all.hpp>
+#include <cstdint>
 #include <random>
 #include "entity.hpp"
+#include "runtime.hpp"
+#include "stable.hpp"
 
 struct dummy {
     int a{};
@@ -28,6 +32,22 @@ TEST_CASE("component", "[component]") {
         REQUIRE(component_store.add(ecs::entity{}, dummy{}) == ecs::error::exists);
     }
 
+    SECTION("add bulk") {
+        std::vector<ecs::entity> const entities{4, 5, 6};
+        REQUIRE(component_store.add(ecs::entity{1}, dummy{1, ""}) == ecs::error::ok);
+        REQUIRE(component_store.add_bulk(entities, dummy{2, "bulk"}) == ecs::error::ok);
+        REQUIRE(component_store.size() == 4);
+        for (auto const e: entities) {
+            REQUIRE(component_store.get(e).b == "bulk");
+        }
+        REQUIRE(component_store.add_bulk(std::vector<ecs::entity>{7, 4}, dummy{}) == ecs::error::exists);
+        REQUIRE_FALSE(component_store.contains(ecs::entity{7}));
+        // duplicated handles are rejected before anything is added
+        REQUIRE(component_store.add_bulk(std::vector<ecs::entity>{8, 9, 8}, dummy{}) == ecs::error::exists);
+        REQUIRE_FALSE(component_store.contains(ecs::entity{8}));
+        REQUIRE(component_store.size() == 4);
+    }
+
     SECTION("remove simple") {
         auto const e = ecs::entity{};
         REQUIRE(component_store.add(e, dummy{1, "Hello There"}) == ecs::error::ok);
@@ -93,6 +113,36 @@ TEST_CASE("component", "[component]") {
         REQUIRE(component_store.size() == 100);
     }
 
+    SECTION("pages on demand") {
+        REQUIRE(component_store.stats().bytes_reserved == 0);
+        REQUIRE(component_store.add(ecs::entity{}, dummy{}) == ecs::error::ok);
+        REQUIRE(component_store.stats().bytes_reserved == ecs::default_config::page_size * sizeof(dummy));
+    }
+
+    SECTION("shrink to fit") {
+        ecs::entity_store store;
+        std::vector<ecs::entity> entities;
+        for (int i = 0; i < 100; i++) {
+            entities.push_back(store.create());
+            REQUIRE(component_store.add(entities.back(), dummy{i, ""}) == ecs::error::ok);
+        }
+        for (int i = 0; i < 99; i++) {
+            REQUIRE(component_store.remove(entities[i]) == ecs::error::ok);
+        }
+        auto const before = component_store.stats();
+        component_store.shrink_to_fit();
+        auto const after = component_store.stats();
+        REQUIRE(after.bytes_reserved == before.bytes_reserved);
+        REQUIRE(after.index_bytes < before.index_bytes);
+        REQUIRE(component_store.get(entities[99]).a == 99);
+
+        REQUIRE(component_store.remove(entities[99]) == ecs::error::ok);
+        component_store.shrink_to_fit();
+        REQUIRE(component_store.stats().bytes_reserved == 0);
+        REQUIRE(component_store.add(entities[0], dummy{7, ""}) == ecs::error::ok);
+        REQUIRE(component_store.get(entities[0]).a == 7);
+    }
+
     SECTION("clear", "[component]") {
         ecs::entity_store store;
         for (int i = 0; i < 200; i++) {
@@ -128,3 +178,269 @@ TEST_CASE("component", "[component]") {
         REQUIRE(component_store.size() == 20);
     }
 }
+
+struct tag {};
+
+TEST_CASE("tag component", "[component]") {
+    ecs::component<tag, memory_layout::compressed> tag_store;
+
+    SECTION("add") {
+        REQUIRE(tag_store.add(ecs::entity{3}, tag{}) == ecs::error::ok);
+        REQUIRE(tag_store.add(ecs::entity{3}, tag{}) == ecs::error::exists);
+        REQUIRE(tag_store.contains(ecs::entity{3}));
+        REQUIRE_FALSE(tag_store.contains(ecs::entity{2}));
+        REQUIRE_FALSE(tag_store.contains(ecs::entity{4000}));
+        REQUIRE(tag_store.size() == 1);
+    }
+
+    SECTION("remove") {
+        REQUIRE(tag_store.add(ecs::entity{1}, tag{}) == ecs::error::ok);
+        REQUIRE(tag_store.remove(ecs::entity{1}) == ecs::error::ok);
+        REQUIRE(tag_store.remove(ecs::entity{1}) == ecs::error::not_found);
+        REQUIRE(tag_store.size() == 0);
+    }
+
+    SECTION("get shared instance") {
+        REQUIRE(tag_store.add(ecs::entity{1}, tag{}) == ecs::error::ok);
+        REQUIRE(tag_store.add(ecs::entity{2}, tag{}) == ecs::error::ok);
+        REQUIRE(&tag_store.get(ecs::entity{1}) == &tag_store.get(ecs::entity{2}));
+        REQUIRE_THROWS_AS(tag_store.get(ecs::entity{3}), std::out_of_range);
+    }
+
+    SECTION("max entities") {
+        for (std::size_t i = 0; i < ecs::ENTITY_COUNT; i++) {
+            REQUIRE(tag_store.add(static_cast<ecs::entity>(i), tag{}) == ecs::error::ok);
+        }
+        REQUIRE(tag_store.add(static_cast<ecs::entity>(ecs::ENTITY_COUNT), tag{}) == ecs::error::max_entities);
+    }
+
+    SECTION("no value storage") {
+        REQUIRE(tag_store.add(ecs::entity{1}, tag{}) == ecs::error::ok);
+        auto const stats = tag_store.stats();
+        REQUIRE(stats.bytes_reserved == 0);
+        REQUIRE(stats.bytes_used == 0);
+    }
+
+    SECTION("clear") {
+        REQUIRE(tag_store.add(ecs::entity{1}, tag{}) == ecs::error::ok);
+        REQUIRE(tag_store.clear() == ecs::error::ok);
+        REQUIRE(tag_store.size() == 0);
+        REQUIRE_FALSE(tag_store.contains(ecs::entity{1}));
+    }
+}
+
+namespace {
+    // counts living instances to check the lifetime handling of runtime pools
+    struct counted {
+        inline static int alive = 0;
+        std::string value;
+
+        explicit counted(std::string v = {}) : value{std::move(v)} { ++alive; }
+        counted(counted const &other) : value{other.value} { ++alive; }
+        counted(counted &&other) noexcept : value{std::move(other.value)} { ++alive; }
+        ~counted() { --alive; }
+    };
+} // namespace
+
+TEST_CASE("runtime component", "[component]") {
+    counted::alive = 0;
+
+    SECTION("lifetime") {
+        {
+            ecs::runtime_component<memory_layout::compressed> pool{ecs::describe<counted>("counted")};
+            counted const value{"a"};
+            REQUIRE(pool.add(0, &value) == ecs::error::ok);
+            REQUIRE(pool.add(1, nullptr) == ecs::error::ok);
+            REQUIRE(pool.add(2, &value) == ecs::error::ok);
+            REQUIRE(pool.add(2, &value) == ecs::error::exists);
+            REQUIRE(counted::alive == 4);
+
+            REQUIRE(pool.remove(0) == ecs::error::ok);
+            REQUIRE(counted::alive == 3);
+            REQUIRE(static_cast<counted *>(pool.try_get(2))->value == "a");
+            REQUIRE(static_cast<counted *>(pool.try_get(1))->value.empty());
+            REQUIRE(pool.try_get(0) == nullptr);
+            REQUIRE(pool.stats().type_name == "counted");
+        }
+        REQUIRE(counted::alive == 0);
+    }
+
+    SECTION("copy without move") {
+        {
+            auto descriptor = ecs::describe<counted>("counted");
+            descriptor.move = nullptr;
+            ecs::runtime_component<memory_layout::compressed> pool{std::move(descriptor)};
+            counted const first{"first"};
+            counted const second{std::string(64, 'b')};
+            REQUIRE(pool.add(0, &first) == ecs::error::ok);
+            REQUIRE(pool.add(1, &second) == ecs::error::ok);
+            REQUIRE(pool.remove(0) == ecs::error::ok);
+            REQUIRE(counted::alive == 3);
+            REQUIRE(static_cast<counted *>(pool.try_get(1))->value == second.value);
+        }
+        REQUIRE(counted::alive == 0);
+    }
+
+    SECTION("destroy without copy") {
+        // relocated bytes are not destroyed, only the removed value
+        static int destroyed = 0;
+        destroyed = 0;
+        ecs::runtime_component<memory_layout::compressed> pool{
+                {.name = "handle", .size = 4, .alignment = 4, .destroy = [](void *) { ++destroyed; }}};
+        for (ecs::entity e = 0; e < 3; e++) {
+            REQUIRE(pool.add(e, &e) == ecs::error::ok);
+        }
+        REQUIRE(pool.remove(0) == ecs::error::ok);
+        REQUIRE(destroyed == 1);
+        REQUIRE(*static_cast<ecs::entity *>(pool.try_get(2)) == 2);
+        REQUIRE(pool.clear() == ecs::error::ok);
+        REQUIRE(destroyed == 3);
+    }
+
+    SECTION("trivial descriptor") {
+        struct vec3 {
+            float x, y, z;
+        };
+        ecs::runtime_component<memory_layout::compressed> pool{{.name = "vec3", .size = 12, .alignment = 4}};
+        for (ecs::entity e = 0; e < 100; e++) {
+            vec3 const value{static_cast<float>(e), 0, 0};
+            REQUIRE(pool.add(e, &value) == ecs::error::ok);
+        }
+        REQUIRE(pool.add(100, nullptr) == ecs::error::failed);
+        for (ecs::entity e = 0; e < 100; e += 2) {
+            REQUIRE(pool.remove(e) == ecs::error::ok);
+        }
+        for (ecs::entity e = 1; e < 100; e += 2) {
+            auto const *value = static_cast<vec3 const *>(pool.try_get(e));
+            REQUIRE(value->x == static_cast<float>(e));
+            REQUIRE(reinterpret_cast<std::uintptr_t>(value) % 4 == 0);
+        }
+        REQUIRE(pool.stats().bytes_used == 50 * 12);
+    }
+
+    SECTION("over aligned") {
+        ecs::runtime_component<memory_layout::compressed> pool{{.name = "wide", .size = 24, .alignment = 64}};
+        for (ecs::entity e = 0; e < 4; e++) {
+            REQUIRE(pool.add(e, std::array<std::byte, 24>{}.data()) == ecs::error::ok);
+            REQUIRE(reinterpret_cast<std::uintptr_t>(pool.try_get(e)) % 64 == 0);
+        }
+    }
+
+    SECTION("invalid alignment") {
+        REQUIRE_THROWS_AS(
+                (ecs::runtime_component<memory_layout::compressed>{{.name = "bad", .size = 4, .alignment = 3}}),
+                std::invalid_argument);
+    }
+}
+
+TEST_CASE("sparse layout", "[component]") {
+    ecs::component<dummy, memory_layout::sparse> component_store;
+    for (ecs::entity e = 0; e < 100; e++) {
+        REQUIRE(component_store.add(e * 3, dummy{static_cast<int>(e), ""}) == ecs::error::ok);
+    }
+    REQUIRE(component_store.add(3, dummy{}) == ecs::error::exists);
+    REQUIRE_FALSE(component_store.contains(1));
+
+    SECTION("remove keeps the index consistent") {
+        for (ecs::entity e = 0; e < 100; e += 2) {
+            REQUIRE(component_store.remove(e * 3) == ecs::error::ok);
+        }
+        REQUIRE(component_store.remove(0) == ecs::error::not_found);
+        REQUIRE(component_store.size() == 50);
+        for (ecs::entity e = 1; e < 100; e += 2) {
+            REQUIRE(component_store.get(e * 3).a == static_cast<int>(e));
+        }
+        for (auto const e: component_store.entities()) {
+            REQUIRE(component_store.contains(e));
+        }
+    }
+
+    SECTION("clear and shrink") {
+        auto const before = component_store.stats().index_bytes;
+        REQUIRE(component_store.remove(297) == ecs::error::ok);
+        component_store.shrink_to_fit();
+        REQUIRE(component_store.stats().index_bytes <= before);
+        REQUIRE(component_store.clear() == ecs::error::ok);
+        REQUIRE_FALSE(component_store.contains(3));
+        REQUIRE(component_store.add(3, dummy{1, ""}) == ecs::error::ok);
+        REQUIRE(component_store.get(3).a == 1);
+    }
+
+    SECTION("stale handles") {
+        using versioned_config = ecs::basic_config<std::uint32_t, 8, 64, 1000, memory_layout::basic_sparse>;
+        ecs::component<dummy, versioned_config::layout_type> versioned;
+        auto const e = versioned_config::make_entity(5, 0);
+        REQUIRE(versioned.add(e, dummy{}) == ecs::error::ok);
+        REQUIRE_FALSE(versioned.contains(versioned_config::next_version(e)));
+        REQUIRE(versioned.remove(versioned_config::next_version(e)) == ecs::error::not_found);
+    }
+}
+
+TEST_CASE("stable component", "[component]") {
+    ecs::stable_component<dummy, ecs::default_config> component_store;
+    for (ecs::entity e = 0; e < 10; e++) {
+        REQUIRE(component_store.add(e, dummy{static_cast<int>(e), "value"}) == ecs::error::ok);
+    }
+
+    SECTION("pointers survive removal") {
+        std::vector<dummy *> pointers;
+        for (ecs::entity e = 0; e < 10; e++) {
+            pointers.push_back(&component_store.get(e));
+        }
+        REQUIRE(component_store.remove(0) == ecs::error::ok);
+        REQUIRE(component_store.remove(5) == ecs::error::ok);
+        REQUIRE(component_store.remove(5) == ecs::error::not_found);
+        for (ecs::entity e = 1; e < 10; e++) {
+            if (e != 5) {
+                REQUIRE(&component_store.get(e) == pointers[e]);
+                REQUIRE(pointers[e]->a == static_cast<int>(e));
+            }
+        }
+        REQUIRE(component_store.size() == 8);
+        REQUIRE(component_store.holes() == 2);
+        REQUIRE(component_store.stats().swaps == 0);
+    }
+
+    SECTION("tombstones are reused") {
+        auto *removed = &component_store.get(3);
+        REQUIRE(component_store.remove(3) == ecs::error::ok);
+        REQUIRE(removed->b.empty());
+        REQUIRE(component_store.add(42, dummy{42, ""}) == ecs::error::ok);
+        REQUIRE(&component_store.get(42) == removed);
+        REQUIRE(component_store.holes() == 0);
+        REQUIRE(component_store.add(42, dummy{}) == ecs::error::exists);
+    }
+
+    SECTION("each skips tombstones") {
+        REQUIRE(component_store.remove(2) == ecs::error::ok);
+        REQUIRE(component_store.remove(7) == ecs::error::ok);
+        int count = 0;
+        component_store.each([&count](ecs::entity e, dummy const &value) {
+            REQUIRE(e != 2);
+            REQUIRE(e != 7);
+            REQUIRE(value.a == static_cast<int>(e));
+            ++count;
+        });
+        REQUIRE(count == 8);
+    }
+
+    SECTION("shrink to fit") {
+        auto *kept = &component_store.get(0);
+        for (ecs::entity e = 1; e < 10; e++) {
+            REQUIRE(component_store.remove(e) == ecs::error::ok);
+        }
+        component_store.shrink_to_fit();
+        REQUIRE(component_store.holes() == 0);
+        REQUIRE(&component_store.get(0) == kept);
+        REQUIRE(component_store.remove(0) == ecs::error::ok);
+        component_store.shrink_to_fit();
+        REQUIRE(component_store.stats().bytes_reserved == 0);
+    }
+
+    SECTION("clear") {
+        REQUIRE(component_store.clear() == ecs::error::ok);
+        REQUIRE(component_store.size() == 0);
+        REQUIRE_FALSE(component_store.contains(1));
+        REQUIRE(component_store.add(1, dummy{}) == ecs::error::ok);
+    }
+}
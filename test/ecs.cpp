@@ -3,6 +3,11 @@
 //
 #include "ecs.hpp"
 #include <catch2/catch_all.hpp>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <thread>
+#include <unordered_set>
 
 struct position {
     int dx{};
@@ -19,6 +24,29 @@ struct render_target {
     int h{};
 };
 
+struct enemy {};
+
+struct dirty {};
+
+struct rigid_body {
+    static constexpr bool pointer_stable = true;
+    float mass{};
+};
+
+struct audio_source {
+    int channel{};
+};
+
+template<>
+struct ecs::component_traits<audio_source> {
+    static constexpr bool pointer_stable = true;
+};
+
+struct health {
+    static constexpr bool double_buffered = true;
+    int value{};
+};
+
 struct not_default_constructable {
     int a;
 
@@ -65,6 +93,65 @@ TEST_CASE("insert", "[ecs]") {
         REQUIRE(ecs.insert(e, position{0, 0}) == ecs::error::ok);
         REQUIRE(ecs.insert(e, position{0, 0}) == ecs::error::exists);
     }
+    SECTION("insert bulk duplicated handle") {
+        auto const a = ecs.create();
+        std::vector<ecs::entity> const entities{a, a};
+        REQUIRE(ecs.insert_bulk(std::span<ecs::entity const>{entities}, position{7, 7}) == ecs::error::exists);
+        REQUIRE_FALSE(ecs.contains<position>(a));
+        REQUIRE(ecs.insert_bulk(std::span<ecs::entity const>{entities}, health{7}) == ecs::error::exists);
+        REQUIRE_FALSE(ecs.contains<health>(a));
+        REQUIRE(ecs.insert_bulk(std::span<ecs::entity const>{entities}, rigid_body{}) == ecs::error::exists);
+        REQUIRE_FALSE(ecs.contains<rigid_body>(a));
+    }
+}
+
+TEST_CASE("reserve", "[ecs]") {
+    ecs::ecs ecs;
+    auto const before = ecs.create();
+
+    std::vector<std::vector<ecs::entity>> reserved(4);
+    std::vector<std::thread> workers;
+    for (auto &handles: reserved) {
+        workers.emplace_back([&ecs, &handles] {
+            for (int i = 0; i < 200; i++) {
+                handles.push_back(ecs.reserve());
+            }
+        });
+    }
+    // the owning thread keeps using the world meanwhile
+    std::vector<ecs::entity> created;
+    for (int i = 0; i < 50; i++) {
+        created.push_back(ecs.create());
+        REQUIRE(ecs.insert(created.back(), position{i, i}) == ecs::error::ok);
+    }
+    REQUIRE(ecs.destroy(created.front()) == ecs::error::ok);
+    for (auto &worker: workers) {
+        worker.join();
+    }
+
+    REQUIRE_FALSE(ecs.alive(reserved[0][0]));
+    REQUIRE(ecs.flush() == 800);
+    REQUIRE(ecs.flush() == 0);
+
+    std::unordered_set<ecs::entity> unique{before};
+    unique.insert(created.begin(), created.end());
+    for (auto const &handles: reserved) {
+        for (auto const e: handles) {
+            REQUIRE(ecs.alive(e));
+            REQUIRE(unique.insert(e).second);
+        }
+    }
+    REQUIRE(unique.size() == 851);
+    // a destroyed entity is not adopted again
+    REQUIRE_FALSE(ecs.alive(created.front()));
+    REQUIRE(ecs.alive(created.back()));
+
+    REQUIRE(ecs.insert(reserved[1][7], velocity{1, 1}) == ecs::error::ok);
+    REQUIRE(ecs.destroy(reserved[1][7]) == ecs::error::ok);
+    REQUIRE_FALSE(ecs.contains<velocity>(reserved[1][7]));
+    // destroyed handles are recycled in order
+    REQUIRE(ecs.create() == created.front());
+    REQUIRE(ecs.create() == reserved[1][7]);
 }
 
 TEST_CASE("contains", "[ecs]") {
@@ -212,6 +299,44 @@ TEST_CASE("get", "[ecs]") {
     }
 }
 
+TEST_CASE("try_get", "[ecs]") {
+    ecs::ecs ecs;
+    auto const e1 = ecs.create();
+    auto const e2 = ecs.create();
+    REQUIRE(ecs.insert(e1, position{4, 2}) == ecs::error::ok);
+    REQUIRE(ecs.emplace<enemy>(e1) == ecs::error::ok);
+
+    STATIC_REQUIRE(noexcept(ecs.try_get<position>(e1)));
+    STATIC_REQUIRE(noexcept(ecs.contains<position>(e1)));
+    STATIC_REQUIRE(noexcept(ecs.all_of<position, velocity>(e1)));
+    STATIC_REQUIRE(noexcept(ecs.any_of<position, velocity>(e1)));
+
+    SECTION("hit") {
+        auto *pos = ecs.try_get<position>(e1);
+        REQUIRE(pos != nullptr);
+        REQUIRE(pos->dx == 4);
+        pos->dx = 5;
+        REQUIRE(ecs.get<position>(e1).dx == 5);
+        REQUIRE(ecs.try_get<enemy>(e1) != nullptr);
+    }
+
+    SECTION("miss") {
+        REQUIRE(ecs.try_get<position>(e2) == nullptr);
+        REQUIRE(ecs.try_get<enemy>(e2) == nullptr);
+        // no pool for velocity exists yet
+        REQUIRE(ecs.try_get<velocity>(e1) == nullptr);
+        REQUIRE(ecs.erase<velocity>(e1) == ecs::error::not_found);
+    }
+
+    SECTION("const") {
+        auto const &const_ecs = ecs;
+        auto const *pos = const_ecs.try_get<position>(e1);
+        REQUIRE(pos != nullptr);
+        REQUIRE(pos->dy == 2);
+        REQUIRE(const_ecs.try_get<position>(e2) == nullptr);
+    }
+}
+
 TEST_CASE("view", "[ecs]") {
     ecs::ecs ecs;
     SECTION("simple component") {
@@ -295,3 +420,1009 @@ TEST_CASE("view", "[ecs]") {
         REQUIRE_THROWS_AS(view.get<velocity>(e1), std::out_of_range);
     }
 }
+
+TEST_CASE("view exclude", "[ecs]") {
+    ecs::ecs ecs;
+    auto const e1 = ecs.create();
+    auto const e2 = ecs.create();
+    auto const e3 = ecs.create();
+    REQUIRE(ecs.insert(e1, position{1, 1}) == ecs::error::ok);
+    REQUIRE(ecs.insert(e2, position{2, 2}) == ecs::error::ok);
+    REQUIRE(ecs.insert(e3, position{3, 3}) == ecs::error::ok);
+    REQUIRE(ecs.emplace<enemy>(e2) == ecs::error::ok);
+    REQUIRE(ecs.emplace<enemy, dirty>(e3) == ecs::error::ok);
+
+    SECTION("tag include") {
+        auto view = ecs.view<position, enemy>();
+        std::unordered_set<ecs::entity> const entities{view.begin(), view.end()};
+        REQUIRE(entities == std::unordered_set<ecs::entity>{e2, e3});
+        REQUIRE_NOTHROW(view.get<enemy>(e2));
+    }
+
+    SECTION("tag exclude") {
+        auto view = ecs.view<position>(ecs::exclude<enemy>);
+        std::unordered_set<ecs::entity> const entities{view.begin(), view.end()};
+        REQUIRE(entities == std::unordered_set<ecs::entity>{e1});
+    }
+
+    SECTION("include and exclude") {
+        auto view = ecs.view<position, enemy>(ecs::exclude<dirty>);
+        std::unordered_set<ecs::entity> const entities{view.begin(), view.end()};
+        REQUIRE(entities == std::unordered_set<ecs::entity>{e2});
+    }
+
+    SECTION("destroy tagged") {
+        REQUIRE(ecs.destroy(e3) == ecs::error::ok);
+        REQUIRE_FALSE(ecs.contains<enemy>(e3));
+        auto view = ecs.view<enemy>();
+        std::unordered_set<ecs::entity> const entities{view.begin(), view.end()};
+        REQUIRE(entities == std::unordered_set<ecs::entity>{e2});
+    }
+}
+
+TEST_CASE("view each", "[ecs]") {
+    ecs::ecs ecs;
+    auto const e1 = ecs.create();
+    auto const e2 = ecs.create();
+    REQUIRE(ecs.insert(e1, position{1, 1}) == ecs::error::ok);
+    REQUIRE(ecs.insert(e2, position{2, 2}) == ecs::error::ok);
+    REQUIRE(ecs.insert(e2, velocity{1, 1}) == ecs::error::ok);
+
+    SECTION("components only") {
+        auto view = ecs.view<position, velocity>();
+        view.each<position, velocity>([](position &pos, velocity const &vel) {
+            pos.dx += vel.dx;
+            pos.dy += vel.dy;
+        });
+        REQUIRE(ecs.get<position>(e2).dx == 3);
+        REQUIRE(ecs.get<position>(e1).dx == 1);
+    }
+
+    SECTION("with entity") {
+        auto view = ecs.view<position>();
+        int count = 0;
+        view.each<position>([&](ecs::entity e, position const &pos) {
+            REQUIRE(pos.dx == static_cast<int>(e) + 1);
+            ++count;
+        });
+        REQUIRE(count == 2);
+    }
+}
+
+TEST_CASE("query", "[ecs]") {
+    ecs::ecs ecs;
+    auto const e1 = ecs.create();
+    auto const e2 = ecs.create();
+    auto const e3 = ecs.create();
+    REQUIRE(ecs.insert(e1, position{1, 1}) == ecs::error::ok);
+    REQUIRE(ecs.insert(e2, position{2, 2}) == ecs::error::ok);
+    REQUIRE(ecs.insert(e2, velocity{1, 1}) == ecs::error::ok);
+
+    auto query = ecs.query<position, velocity>();
+    auto const entities = [&query] { return std::unordered_set<ecs::entity>{query.begin(), query.end()}; };
+    REQUIRE(entities() == std::unordered_set<ecs::entity>{e2});
+
+    SECTION("insert") {
+        REQUIRE(ecs.insert(e1, velocity{}) == ecs::error::ok);
+        REQUIRE(ecs.emplace<position, velocity>(e3) == ecs::error::ok);
+        REQUIRE(entities() == std::unordered_set<ecs::entity>{e1, e2, e3});
+    }
+
+    SECTION("insert bulk") {
+        std::vector const bulk{e1, e3};
+        REQUIRE(ecs.insert_bulk(std::span<ecs::entity const>{bulk}, velocity{}) == ecs::error::ok);
+        REQUIRE(entities() == std::unordered_set<ecs::entity>{e1, e2});
+    }
+
+    SECTION("erase") {
+        REQUIRE(ecs.erase<velocity>(e2) == ecs::error::ok);
+        REQUIRE(query.empty());
+        REQUIRE(ecs.erase<velocity>(e2) == ecs::error::not_found);
+    }
+
+    SECTION("destroy") {
+        REQUIRE(ecs.destroy(e2) == ecs::error::ok);
+        REQUIRE_FALSE(query.contains(e2));
+        REQUIRE(ecs.destroy(e1) == ecs::error::ok);
+        REQUIRE(query.empty());
+    }
+
+    SECTION("clear") {
+        REQUIRE(ecs.clear() == ecs::error::ok);
+        REQUIRE(query.empty());
+        auto const e = ecs.create();
+        REQUIRE(ecs.emplace<position, velocity>(e) == ecs::error::ok);
+        REQUIRE(entities() == std::unordered_set<ecs::entity>{e});
+    }
+
+    SECTION("exclude") {
+        auto moving = ecs.query<position>(ecs::exclude<dirty>);
+        REQUIRE(moving.size() == 2);
+        REQUIRE(ecs.emplace<dirty>(e1) == ecs::error::ok);
+        REQUIRE_FALSE(moving.contains(e1));
+        REQUIRE(ecs.erase<dirty>(e1) == ecs::error::ok);
+        REQUIRE(moving.contains(e1));
+    }
+
+    SECTION("shared storage") {
+        auto other = ecs.query<velocity, position>();
+        REQUIRE(ecs.query_count() == 1);
+        REQUIRE(ecs.insert(e1, velocity{}) == ecs::error::ok);
+        REQUIRE(other.size() == 2);
+        REQUIRE(query.size() == 2);
+        auto const excluding = ecs.query<position, velocity>(ecs::exclude<dirty>);
+        REQUIRE(ecs.query_count() == 2);
+    }
+
+    SECTION("release") {
+        {
+            auto const excluding = ecs.query<position>(ecs::exclude<dirty>);
+            auto const copy = excluding;
+            REQUIRE(ecs.query_count() == 2);
+        }
+        REQUIRE(ecs.query_count() == 1);
+        // the released storage must not be notified anymore
+        REQUIRE(ecs.emplace<dirty>(e1) == ecs::error::ok);
+        REQUIRE(ecs.erase<position>(e2) == ecs::error::ok);
+        auto const again = ecs.query<position>(ecs::exclude<dirty>);
+        REQUIRE(ecs.query_count() == 2);
+        REQUIRE(again.empty());
+    }
+
+    SECTION("outliving the ecs") {
+        auto other = std::make_unique<ecs::ecs>();
+        auto const outliving = other->query<position>();
+        other.reset();
+        REQUIRE(outliving.empty());
+    }
+
+    SECTION("each") {
+        query.each<position, velocity>([](position &pos, velocity const &vel) { pos.dx += vel.dx; });
+        REQUIRE(ecs.get<position>(e2).dx == 3);
+        REQUIRE(ecs.get<position>(e1).dx == 1);
+    }
+
+    SECTION("matches view") {
+        for (int i = 0; i < 200; ++i) {
+            auto const e = ecs.create();
+            if (i % 2 == 0) {
+                REQUIRE(ecs.emplace<position>(e) == ecs::error::ok);
+            }
+            if (i % 3 == 0) {
+                REQUIRE(ecs.emplace<velocity>(e) == ecs::error::ok);
+            }
+            if (i % 5 == 0) {
+                REQUIRE(ecs.destroy(e) == ecs::error::ok);
+            }
+        }
+        auto view = ecs.view<position, velocity>();
+        REQUIRE(entities() == std::unordered_set<ecs::entity>{view.begin(), view.end()});
+    }
+}
+
+TEST_CASE("cursor", "[ecs]") {
+    ecs::ecs ecs;
+    std::vector<ecs::entity> entities;
+    for (int i = 0; i < 10; i++) {
+        entities.push_back(ecs.create());
+        REQUIRE(ecs.insert(entities.back(), position{i, 0}) == ecs::error::ok);
+    }
+    auto cursor = ecs.cursor<position>();
+    std::vector<ecs::entity> visited;
+    auto const visit = [&visited](ecs::entity e, position &pos) {
+        ++pos.dy;
+        visited.push_back(e);
+    };
+
+    SECTION("item budget") {
+        auto result = cursor.step<position>(4, visit);
+        REQUIRE(result.processed == 4);
+        REQUIRE_FALSE(result.finished);
+        REQUIRE(cursor.in_pass());
+        REQUIRE(cursor.remaining() == 6);
+
+        cursor.step<position>(4, visit);
+        result = cursor.step<position>(4, visit);
+        REQUIRE(result.processed == 2);
+        REQUIRE(result.finished);
+        REQUIRE_FALSE(cursor.in_pass());
+        REQUIRE(std::unordered_set<ecs::entity>{visited.begin(), visited.end()}.size() == 10);
+        for (auto const e: entities) {
+            REQUIRE(ecs.get<position>(e).dy == 1);
+        }
+    }
+
+    SECTION("structural changes between steps") {
+        // lifo hands the destroyed handle out again right away, the new entity must still wait for the next pass
+        ecs.set_recycle_policy(ecs::recycle_policy::lifo);
+        cursor.step<position>(3, visit);
+        auto destroyed = ecs::null_entity;
+        for (auto const e: entities) {
+            if (std::find(visited.begin(), visited.end(), e) == visited.end()) {
+                destroyed = e;
+                REQUIRE(ecs.destroy(e) == ecs::error::ok);
+                break;
+            }
+        }
+        auto const added = ecs.create();
+        REQUIRE(added == destroyed);
+        REQUIRE(ecs.insert(added, position{}) == ecs::error::ok);
+
+        while (!cursor.step<position>(2, visit).finished) {
+        }
+        REQUIRE(visited.size() == 9);
+        REQUIRE(std::unordered_set<ecs::entity>{visited.begin(), visited.end()}.size() == 9);
+        REQUIRE(std::find(visited.begin(), visited.end(), added) == visited.end());
+
+        visited.clear();
+        REQUIRE(cursor.step<position>(100, visit).processed == 10);
+        REQUIRE(std::find(visited.begin(), visited.end(), added) != visited.end());
+    }
+
+    SECTION("time budget") {
+        auto const result = cursor.step_for<position>(std::chrono::seconds{10}, visit);
+        REQUIRE(result.processed == 10);
+        REQUIRE(result.finished);
+        REQUIRE(cursor.step_for<position>(std::chrono::nanoseconds{0}, visit).processed == 0);
+        REQUIRE(cursor.in_pass());
+    }
+
+    SECTION("reset") {
+        cursor.step<position>(5, visit);
+        cursor.reset();
+        REQUIRE(cursor.step<position>(100, [](position &) {}).processed == 10);
+    }
+}
+
+TEST_CASE("spatial index", "[ecs]") {
+    ecs::ecs ecs;
+    auto const e1 = ecs.create();
+    auto const e2 = ecs.create();
+    auto const e3 = ecs.create();
+    REQUIRE(ecs.insert(e1, position{0, 0}) == ecs::error::ok);
+    REQUIRE(ecs.insert(e2, position{3, 4}) == ecs::error::ok);
+    REQUIRE(ecs.insert(e2, velocity{1, 1}) == ecs::error::ok);
+
+    REQUIRE(ecs.spatial_index<position>() == nullptr);
+    auto const &index = ecs.make_spatial_index<position>(
+            8.0f, [](position const &pos) { return ecs::point{static_cast<float>(pos.dx), static_cast<float>(pos.dy)}; });
+    REQUIRE(ecs.spatial_index<position>() == &index);
+    REQUIRE(index.size() == 2);
+
+    SECTION("insert") {
+        REQUIRE(ecs.insert(e3, position{1, 1}) == ecs::error::ok);
+        REQUIRE(index.nearest({0, 0}, 2) == std::vector<ecs::entity>{e1, e3});
+    }
+
+    SECTION("patch") {
+        REQUIRE(ecs.patch<position>(e2, [](position &pos) { pos.dx = 100; }) == ecs::error::ok);
+        REQUIRE(index.radius({0, 0}, 5) == std::vector<ecs::entity>{e1});
+        REQUIRE(index.position(e2).value() == ecs::point{100, 4});
+        REQUIRE(ecs.patch<position>(e3, [](position &) {}) == ecs::error::not_found);
+    }
+
+    SECTION("erase and destroy") {
+        REQUIRE(ecs.erase<position>(e1) == ecs::error::ok);
+        REQUIRE_FALSE(index.contains(e1));
+        REQUIRE(ecs.destroy(e2) == ecs::error::ok);
+        REQUIRE(index.size() == 0);
+    }
+
+    SECTION("clear") {
+        REQUIRE(ecs.clear() == ecs::error::ok);
+        REQUIRE(index.size() == 0);
+    }
+
+    SECTION("view of candidates") {
+        auto const near = index.radius({0, 0}, 5);
+        REQUIRE(near.size() == 2);
+        auto view = ecs.view<position, velocity>(near);
+        std::unordered_set<ecs::entity> const entities{view.begin(), view.end()};
+        REQUIRE(entities == std::unordered_set<ecs::entity>{e2});
+
+        auto excluding = ecs.view<position>(near, ecs::exclude<velocity>);
+        REQUIRE(std::unordered_set<ecs::entity>{excluding.begin(), excluding.end()} ==
+                std::unordered_set<ecs::entity>{e1});
+    }
+}
+
+TEST_CASE("runtime components", "[ecs]") {
+    ecs::ecs ecs;
+    auto const health = ecs.register_component({.name = "health", .size = sizeof(int), .alignment = alignof(int)});
+    auto const name = ecs.register_component(ecs::describe<std::string>("name"));
+    REQUIRE(health != name);
+    REQUIRE(health != ecs::type_id<position>());
+
+    auto const e1 = ecs.create();
+    auto const e2 = ecs.create();
+    auto const e3 = ecs.create();
+    int const hp = 10;
+    std::string const label = "orc";
+    REQUIRE(ecs.insert(health, e1, &hp) == ecs::error::ok);
+    REQUIRE(ecs.insert(health, e2, &hp) == ecs::error::ok);
+    REQUIRE(ecs.insert(name, e2, &label) == ecs::error::ok);
+    REQUIRE(ecs.insert(name, e3, nullptr) == ecs::error::ok);
+    REQUIRE(ecs.insert(e2, position{1, 1}) == ecs::error::ok);
+    REQUIRE(ecs.insert(e3, position{2, 2}) == ecs::error::ok);
+
+    SECTION("access") {
+        REQUIRE(ecs.contains(health, e1));
+        REQUIRE_FALSE(ecs.contains(name, e1));
+        REQUIRE(*static_cast<int *>(ecs.try_get(health, e1)) == 10);
+        REQUIRE(static_cast<std::string *>(ecs.try_get(name, e3))->empty());
+        REQUIRE(ecs.try_get(name, e1) == nullptr);
+        REQUIRE(ecs.insert(9999, e1, &hp) == ecs::error::not_found);
+        REQUIRE(ecs.insert(health, e1, nullptr) == ecs::error::failed);
+    }
+
+    SECTION("erase and destroy") {
+        REQUIRE(ecs.erase(health, e1) == ecs::error::ok);
+        REQUIRE(ecs.erase(health, e1) == ecs::error::not_found);
+        REQUIRE(ecs.destroy(e2) == ecs::error::ok);
+        REQUIRE_FALSE(ecs.contains(name, e2));
+    }
+
+    SECTION("static ids") {
+        auto const position_id = ecs::type_id<position>();
+        REQUIRE(ecs.contains(position_id, e2));
+        position const pos{5, 5};
+        REQUIRE(ecs.insert(position_id, e1, &pos) == ecs::error::ok);
+        REQUIRE(ecs.get<position>(e1).dx == 5);
+        REQUIRE(static_cast<position *>(ecs.try_get(position_id, e1))->dy == 5);
+    }
+
+    SECTION("mixed view") {
+        std::vector const include{name, ecs::type_id<position>()};
+        std::vector const exclude{health};
+        auto view = ecs.runtime_view(include, exclude);
+        REQUIRE(std::vector<ecs::entity>{view.begin(), view.end()} == std::vector<ecs::entity>{e3});
+
+        auto all = ecs.runtime_view(include);
+        REQUIRE(all.size() == 2);
+        int count = 0;
+        all.each([&](ecs::entity e, std::span<void *const> components) {
+            REQUIRE(components.size() == 2);
+            REQUIRE(static_cast<position *>(components[1])->dx == static_cast<int>(e));
+            ++count;
+        });
+        REQUIRE(count == 2);
+        REQUIRE(*static_cast<std::string *>(all.get(e2, name)) == "orc");
+        REQUIRE(all.get(e2, health) == nullptr);
+    }
+
+    SECTION("stats") {
+        auto const stats = ecs.stats();
+        REQUIRE(std::any_of(stats.begin(), stats.end(), [](auto const &pool) { return pool.type_name == "health"; }));
+    }
+}
+
+TEST_CASE("pointer stable components", "[ecs]") {
+    STATIC_REQUIRE(std::is_same_v<ecs::ecs::component_type<rigid_body>,
+                                  ecs::stable_component<rigid_body, ecs::default_config>>);
+    STATIC_REQUIRE(std::is_same_v<ecs::ecs::component_type<audio_source>,
+                                  ecs::stable_component<audio_source, ecs::default_config>>);
+    STATIC_REQUIRE(!std::is_same_v<ecs::ecs::component_type<position>,
+                                   ecs::stable_component<position, ecs::default_config>>);
+
+    ecs::ecs ecs;
+    std::vector<ecs::entity> entities;
+    for (int i = 0; i < 10; i++) {
+        entities.push_back(ecs.create());
+        REQUIRE(ecs.insert(entities.back(), rigid_body{static_cast<float>(i)}) == ecs::error::ok);
+    }
+    auto *last = &ecs.get<rigid_body>(entities.back());
+    REQUIRE(ecs.erase<rigid_body>(entities[0]) == ecs::error::ok);
+    REQUIRE(ecs.destroy(entities[4]) == ecs::error::ok);
+    REQUIRE(&ecs.get<rigid_body>(entities.back()) == last);
+    REQUIRE(last->mass == 9);
+
+    float total = 0;
+    ecs.view<rigid_body>().each<rigid_body>([&total](rigid_body const &body) { total += body.mass; });
+    REQUIRE(total == 45 - 4);
+
+    auto query = ecs.query<rigid_body>();
+    REQUIRE(query.size() == 8);
+    REQUIRE(ecs.insert(entities[0], audio_source{3}) == ecs::error::ok);
+    REQUIRE(ecs.try_get<audio_source>(entities[0])->channel == 3);
+}
+
+TEST_CASE("double buffered components", "[ecs]") {
+    STATIC_REQUIRE(std::is_same_v<ecs::ecs::component_type<health>,
+                                  ecs::buffered_component<health, ecs::default_config>>);
+
+    ecs::ecs ecs;
+    auto const e1 = ecs.create();
+    auto const e2 = ecs.create();
+    REQUIRE(ecs.insert(e1, health{10}) == ecs::error::ok);
+    REQUIRE(ecs.insert(e2, health{20}) == ecs::error::ok);
+    REQUIRE(ecs.get_prev<health>(e1).value == 10);
+
+    // one tick: read previous, write next
+    auto const tick = [&ecs] {
+        ecs.view<health>().each<ecs::prev<health>, health>(
+                [](health const &prev, health &next) { next.value = prev.value - 1; });
+        ecs.swap_buffers();
+    };
+
+    SECTION("read previous write next") {
+        ecs.view<health>().each<ecs::prev<health>, health>([](health const &prev, health &next) {
+            next.value = prev.value * 2;
+            REQUIRE(prev.value * 2 == next.value);
+        });
+        REQUIRE(ecs.get<health>(e1).value == 20);
+        REQUIRE(ecs.get_prev<health>(e1).value == 10);
+        ecs.swap_buffers();
+        REQUIRE(ecs.get_prev<health>(e1).value == 20);
+        REQUIRE(ecs.get_prev<health>(e2).value == 40);
+    }
+
+    SECTION("ticks") {
+        for (int i = 0; i < 5; i++) {
+            tick();
+        }
+        REQUIRE(ecs.get_prev<health>(e1).value == 5);
+        REQUIRE(ecs.get_prev<health>(e2).value == 15);
+    }
+
+    SECTION("remove keeps buffers aligned") {
+        tick();
+        REQUIRE(ecs.erase<health>(e1) == ecs::error::ok);
+        REQUIRE(ecs.get_prev<health>(e2).value == 19);
+        tick();
+        REQUIRE(ecs.get_prev<health>(e2).value == 18);
+        REQUIRE_THROWS_AS(ecs.get_prev<health>(e1), std::out_of_range);
+    }
+
+    SECTION("query and entity") {
+        auto query = ecs.query<health>();
+        query.each<ecs::prev<health>, health>([](ecs::entity, health const &prev, health &next) {
+            next.value = prev.value + 1;
+        });
+        ecs.swap_buffers();
+        REQUIRE(ecs.get_prev<health>(e2).value == 21);
+    }
+}
+
+TEST_CASE("columnar export", "[ecs]") {
+    using small_config = ecs::basic_config<std::uint32_t, 0, 8, 64>;
+    ecs::basic_ecs<small_config> ecs;
+
+    REQUIRE(ecs.column<position>().empty());
+    REQUIRE(ecs.column<position>().chunk_count() == 0);
+
+    std::vector<std::uint32_t> entities;
+    for (int i = 0; i < 20; i++) {
+        entities.push_back(ecs.create());
+        REQUIRE(ecs.insert(entities.back(), position{i, -i}) == ecs::error::ok);
+    }
+
+    SECTION("schema") {
+        auto const schema = ecs.column<position>().schema();
+        REQUIRE(schema.format == "w:8");
+        REQUIRE(schema.entity_format == "I");
+        REQUIRE(schema.byte_width == sizeof(position));
+        REQUIRE(ecs::make_schema<float, small_config>().format == "f");
+        REQUIRE(ecs::make_schema<std::int64_t, small_config>().format == "l");
+        REQUIRE(ecs::make_schema<std::uint16_t, small_config>().format == "S");
+        REQUIRE(ecs::make_schema<bool, small_config>().format == "w:1");
+    }
+
+    SECTION("chunks per page") {
+        auto const column = ecs.column<position>();
+        REQUIRE(column.size() == 20);
+        REQUIRE(column.chunk_count() == 3);
+        REQUIRE(column.chunk(2).values.size() == 4);
+
+        std::size_t visited = 0;
+        column.each_chunk([&](auto const &chunk) {
+            REQUIRE(chunk.entities.size() == chunk.values.size());
+            for (std::size_t i = 0; i < chunk.values.size(); i++) {
+                REQUIRE(ecs.get<position>(chunk.entities[i]).dx == chunk.values[i].dx);
+                // no copy, the spans point into the pool
+                REQUIRE(&chunk.values[i] == ecs.try_get<position>(chunk.entities[i]));
+            }
+            visited += chunk.values.size();
+        });
+        REQUIRE(visited == 20);
+    }
+
+    SECTION("snapshot") {
+        REQUIRE(ecs.insert(entities[3], velocity{1, 1}) == ecs::error::ok);
+        auto const snapshot = ecs.snapshot<position, velocity>();
+        REQUIRE(snapshot.column_count() == 2);
+        REQUIRE_FALSE(snapshot.contains<render_target>());
+        REQUIRE(snapshot.values<render_target>().empty());
+
+        // later changes to the world do not reach the snapshot
+        ecs.get<position>(entities[0]).dx = 100;
+        REQUIRE(ecs.destroy(entities[1]) == ecs::error::ok);
+
+        auto const positions = snapshot.values<position>();
+        REQUIRE(positions.size() == 20);
+        REQUIRE(snapshot.entities<position>().size() == 20);
+        REQUIRE(positions[0].dx == 0);
+        REQUIRE(positions[1].dy == -1);
+        REQUIRE(snapshot.entities<velocity>()[0] == entities[3]);
+        REQUIRE(snapshot.schema(1).byte_width == sizeof(velocity));
+        REQUIRE(static_cast<velocity const *>(snapshot.data(1))->dx == 1);
+    }
+
+    SECTION("double buffered pools export the previous values") {
+        REQUIRE(ecs.insert(entities[0], health{10}) == ecs::error::ok);
+        ecs.get<health>(entities[0]).value = 5;
+        REQUIRE(ecs.column<health>().chunk(0).values[0].value == 10);
+        ecs.swap_buffers();
+        REQUIRE(ecs.column<health>().chunk(0).values[0].value == 5);
+    }
+}
+
+TEST_CASE("reduce", "[ecs]") {
+    ecs::ecs ecs;
+    REQUIRE(ecs.view<position>().reduce<position>(position{3, 3}, [](position a, position) { return a; }).dx == 3);
+    REQUIRE(ecs.reduce<position>(position{7, 7}, [](position a, position) { return a; }).dx == 7);
+
+    std::int64_t expected = 0;
+    for (int i = 0; i < 1000; i++) {
+        auto const e = ecs.create();
+        REQUIRE(ecs.insert(e, position{i, i % 7}) == ecs::error::ok);
+        if (i % 2 == 0) {
+            REQUIRE(ecs.insert(e, velocity{1, 0}) == ecs::error::ok);
+            expected += i;
+        }
+    }
+    ecs::reduce_options const options{.threads = 4, .chunk_size = 32};
+
+    SECTION("sum") {
+        auto const sum = ecs.view<position, velocity>().transform_reduce<position>(
+                std::int64_t{}, std::plus<>{}, [](position const &p) { return std::int64_t{p.dx}; }, options);
+        REQUIRE(sum == expected);
+        auto const count = ecs.view<velocity>().transform_reduce<velocity>(
+                std::size_t{}, std::plus<>{}, [](ecs::entity, velocity const &) { return std::size_t{1}; }, options);
+        REQUIRE(count == 500);
+    }
+
+    SECTION("min max") {
+        auto const max = ecs.view<position>().reduce<position>(
+                position{-1, -1}, [](position a, position b) { return a.dx >= b.dx ? a : b; }, options);
+        REQUIRE(max.dx == 999);
+        using bounds = std::pair<int, int>;
+        auto const range = ecs.view<position>().transform_reduce<position>(
+                bounds{std::numeric_limits<int>::max(), std::numeric_limits<int>::min()},
+                [](bounds a, bounds b) { return bounds{std::min(a.first, b.first), std::max(a.second, b.second)}; },
+                [](position const &p) { return bounds{p.dy, p.dy}; }, options);
+        REQUIRE(range == bounds{0, 6});
+    }
+
+    SECTION("histogram") {
+        using histogram = std::array<int, 7>;
+        auto const result = ecs.transform_reduce<position>(
+                histogram{},
+                [](histogram a, histogram const &b) {
+                    for (std::size_t i = 0; i < a.size(); i++) {
+                        a[i] += b[i];
+                    }
+                    return a;
+                },
+                [](position const &p) {
+                    histogram h{};
+                    ++h[p.dy];
+                    return h;
+                },
+                options);
+        REQUIRE(std::accumulate(result.begin(), result.end(), 0) == 1000);
+        REQUIRE(result[0] == 143);
+    }
+
+    SECTION("dense pools") {
+        auto const sum = ecs.transform_reduce<position>(
+                std::int64_t{}, std::plus<>{}, [](position const &p) { return std::int64_t{p.dx}; }, options);
+        REQUIRE(sum == std::int64_t{999} * 1000 / 2);
+
+        // one chunk per page
+        using small_config = ecs::basic_config<std::uint32_t, 0, 16, 1000>;
+        ecs::basic_ecs<small_config> paged;
+        for (int i = 0; i < 100; i++) {
+            REQUIRE(paged.insert(paged.create(), velocity{i, 1}) == ecs::error::ok);
+        }
+        auto const total = paged.reduce<velocity>(
+                velocity{}, [](velocity a, velocity b) { return velocity{a.dx + b.dx, a.dy + b.dy}; }, options);
+        REQUIRE(total.dx == 4950);
+        REQUIRE(total.dy == 100);
+    }
+
+    SECTION("deterministic") {
+        auto const sum = [&ecs](std::size_t threads) {
+            ecs::reduce_options const fixed{.threads = threads, .chunk_size = 16, .deterministic = true};
+            return ecs.view<position>().transform_reduce<position>(
+                    0.0f, std::plus<>{}, [](position const &p) { return 1.0f / static_cast<float>(p.dx + 1); }, fixed);
+        };
+        auto const serial = sum(1);
+        for (std::size_t threads = 2; threads <= 8; threads++) {
+            REQUIRE(sum(threads) == serial);
+        }
+    }
+
+    SECTION("thread pool") {
+        ecs::thread_pool pool{3};
+        REQUIRE(pool.size() == 3);
+        ecs::reduce_options const pooled{.chunk_size = 32, .pool = &pool};
+        for (int frame = 0; frame < 20; frame++) {
+            auto const sum = ecs.view<position, velocity>().transform_reduce<position>(
+                    std::int64_t{}, std::plus<>{}, [](position const &p) { return std::int64_t{p.dx}; }, pooled);
+            REQUIRE(sum == expected);
+        }
+        REQUIRE_THROWS_AS(ecs.transform_reduce<position>(
+                                  0, std::plus<>{},
+                                  [](position const &) -> int { throw std::runtime_error{"kernel failed"}; }, pooled),
+                          std::runtime_error);
+        REQUIRE(ecs.reduce<velocity>(velocity{}, [](velocity a, velocity b) { return velocity{a.dx + b.dx, 0}; },
+                                     pooled)
+                        .dx == 500);
+    }
+
+    SECTION("views without dense pools") {
+        for (auto const e: ecs.view<velocity>()) {
+            REQUIRE(ecs.emplace<enemy>(e) == ecs::error::ok);
+        }
+        auto const count = ecs.view<enemy>().transform_reduce<>(
+                std::size_t{}, std::plus<>{}, [](ecs::entity) { return std::size_t{1}; }, options);
+        REQUIRE(count == 500);
+        auto const tagged = ecs.view<enemy>().transform_reduce<enemy>(
+                std::size_t{}, std::plus<>{}, [](enemy &) { return std::size_t{1}; }, options);
+        REQUIRE(tagged == 500);
+    }
+
+    SECTION("exceptions") {
+        REQUIRE_THROWS_AS(ecs.view<position>().transform_reduce<position>(
+                                  0, std::plus<>{},
+                                  [](position const &p) {
+                                      if (p.dx == 800) {
+                                          throw std::runtime_error{"kernel failed"};
+                                      }
+                                      return 1;
+                                  },
+                                  options),
+                          std::runtime_error);
+    }
+}
+
+TEST_CASE("stats", "[ecs]") {
+    ecs::ecs ecs;
+    auto const e1 = ecs.create();
+    auto const e2 = ecs.create();
+    auto const e3 = ecs.create();
+    REQUIRE(ecs.emplace<position>(e1) == ecs::error::ok);
+    REQUIRE(ecs.emplace<position>(e2) == ecs::error::ok);
+    REQUIRE(ecs.emplace<position, velocity>(e3) == ecs::error::ok);
+    REQUIRE(ecs.erase<position>(e3) == ecs::error::ok);
+    REQUIRE(ecs.erase<position>(e1) == ecs::error::ok);
+
+    auto const stats = ecs.stats();
+    REQUIRE(stats.size() == 2);
+    for (auto const &pool: stats) {
+        // one page is allocated on the first add
+        REQUIRE(pool.capacity == ecs::default_config::page_size);
+        REQUIRE(pool.bytes_reserved >= pool.capacity * sizeof(velocity));
+        REQUIRE(pool.index_bytes > 0);
+        if (pool.type_name == typeid(position).name()) {
+            REQUIRE(pool.size == 1);
+            REQUIRE(pool.bytes_used == sizeof(position));
+            REQUIRE(pool.adds == 3);
+            REQUIRE(pool.removes == 2);
+            // removing the last element needs no relocation, removing e1 moves e2
+            REQUIRE(pool.swaps == 1);
+        } else {
+            REQUIRE(pool.type_name == typeid(velocity).name());
+            REQUIRE(pool.size == 1);
+            REQUIRE(pool.adds == 1);
+            REQUIRE(pool.removes == 0);
+        }
+    }
+}
+
+namespace {
+    int trace_begin_count{};
+    int trace_end_count{};
+} // namespace
+
+TEST_CASE("compact", "[ecs]") {
+    ecs::ecs ecs{ecs::recycle_policy::lowest_index};
+    std::vector<ecs::entity> entities;
+    for (int i = 0; i < 500; i++) {
+        entities.push_back(ecs.create());
+        REQUIRE(ecs.insert(entities.back(), position{i, i}) == ecs::error::ok);
+    }
+    auto query = ecs.query<position>();
+    for (auto const e: entities) {
+        REQUIRE(ecs.destroy(e) == ecs::error::ok);
+    }
+    auto const peak = ecs.stats().front();
+    ecs.compact();
+    auto const compacted = ecs.stats().front();
+    REQUIRE(compacted.bytes_reserved == 0);
+    REQUIRE(compacted.index_bytes < peak.index_bytes);
+
+    auto const e = ecs.create();
+    REQUIRE(e == 0);
+    REQUIRE(ecs.insert(e, position{1, 2}) == ecs::error::ok);
+    REQUIRE(ecs.get<position>(e).dy == 2);
+    REQUIRE(query.size() == 1);
+}
+
+TEST_CASE("trace hooks", "[ecs]") {
+    trace_begin_count = 0;
+    trace_end_count = 0;
+    ecs::trace::set_hooks({
+            .begin = [](char const *) { ++trace_begin_count; },
+            .end = [](char const *) { ++trace_end_count; },
+    });
+
+    ecs::ecs ecs;
+    auto const e = ecs.create();
+    REQUIRE(ecs.emplace<position>(e) == ecs::error::ok);
+    ecs.view<position>().each<position>([](position &) {});
+    REQUIRE(ecs.destroy(e) == ecs::error::ok);
+    REQUIRE(ecs.clear() == ecs::error::ok);
+    ecs::trace::set_hooks({});
+
+#ifdef ECS_ENABLE_TRACING
+    // view, view::each, destroy, clear
+    REQUIRE(trace_begin_count == 4);
+    REQUIRE(trace_end_count == 4);
+#else
+    REQUIRE(trace_begin_count == 0);
+    REQUIRE(trace_end_count == 0);
+#endif
+}
+
+struct game_time {
+    float dt{};
+    std::uint64_t tick{};
+};
+
+struct config {
+    std::string name;
+};
+
+TEST_CASE("context", "[ecs]") {
+    ecs::ecs ecs;
+
+    SECTION("emplace and get") {
+        auto &time = ecs.ctx_emplace<game_time>(0.016f, 1u);
+        REQUIRE(&time == &ecs.ctx<game_time>());
+        REQUIRE(ecs.ctx<game_time>().tick == 1);
+        ecs.ctx<game_time>().tick += 1;
+        REQUIRE(ecs.ctx<game_time>().tick == 2);
+    }
+
+    SECTION("multiple types") {
+        ecs.ctx_emplace<game_time>();
+        ecs.ctx_emplace<config>("world");
+        REQUIRE(ecs.ctx_contains<game_time>());
+        REQUIRE(ecs.ctx<config>().name == "world");
+    }
+
+    SECTION("replace") {
+        ecs.ctx_emplace<config>("first");
+        ecs.ctx_emplace<config>("second");
+        REQUIRE(ecs.ctx<config>().name == "second");
+    }
+
+    SECTION("missing") {
+        REQUIRE_FALSE(ecs.ctx_contains<game_time>());
+        REQUIRE(ecs.ctx_find<game_time>() == nullptr);
+        REQUIRE_THROWS_AS(ecs.ctx<game_time>(), std::out_of_range);
+        REQUIRE(ecs.ctx_erase<game_time>() == ecs::error::not_found);
+    }
+
+    SECTION("erase") {
+        ecs.ctx_emplace<game_time>();
+        REQUIRE(ecs.ctx_erase<game_time>() == ecs::error::ok);
+        REQUIRE_FALSE(ecs.ctx_contains<game_time>());
+    }
+
+    SECTION("survives clear") {
+        ecs.ctx_emplace<game_time>(0.5f, 3u);
+        auto const e = ecs.create();
+        REQUIRE(ecs.emplace<position>(e) == ecs::error::ok);
+        REQUIRE(ecs.clear() == ecs::error::ok);
+        REQUIRE(ecs.ctx<game_time>().tick == 3);
+    }
+
+    SECTION("const access") {
+        ecs.ctx_emplace<game_time>(0.5f, 3u);
+        auto const &world = ecs;
+        STATIC_REQUIRE(std::is_same_v<decltype(world.ctx<game_time>()), game_time const &>);
+        STATIC_REQUIRE(std::is_same_v<decltype(world.ctx_find<game_time>()), game_time const *>);
+        STATIC_REQUIRE(std::is_same_v<decltype(ecs.ctx<game_time>()), game_time &>);
+        REQUIRE(world.ctx<game_time>().tick == 3);
+        REQUIRE(world.ctx_find<game_time>() == &ecs.ctx<game_time>());
+    }
+}
+
+TEST_CASE("hierarchy", "[ecs]") {
+    ecs::ecs ecs;
+    auto const root = ecs.create();
+    auto const child = ecs.create();
+    auto const grandchild = ecs.create();
+    REQUIRE(ecs.insert(root, position{1, 1}) == ecs::error::ok);
+    REQUIRE(ecs.insert(child, position{2, 2}) == ecs::error::ok);
+    REQUIRE(ecs.insert(grandchild, position{3, 3}) == ecs::error::ok);
+    REQUIRE(ecs.insert(grandchild, velocity{}) == ecs::error::ok);
+    REQUIRE(ecs.attach(grandchild, child) == ecs::error::ok);
+    REQUIRE(ecs.attach(child, root) == ecs::error::ok);
+
+    SECTION("propagate in one pass") {
+        std::unordered_map<ecs::entity, position> world;
+        for (std::size_t i = 0; i < ecs.hierarchy().size(); ++i) {
+            auto const e = ecs.hierarchy().at(i);
+            auto const parent = ecs.hierarchy().relation_at(i).parent;
+            auto local = ecs.get<position>(e);
+            if (parent != ecs::null_entity) {
+                REQUIRE(world.contains(parent));
+                local.dx += world[parent].dx;
+                local.dy += world[parent].dy;
+            }
+            world[e] = local;
+        }
+        REQUIRE(world[grandchild].dx == 6);
+    }
+
+    SECTION("attach dead entities") {
+        auto const dead = ecs.create();
+        REQUIRE(ecs.destroy(dead) == ecs::error::ok);
+        REQUIRE(ecs.attach(dead, root) == ecs::error::not_found);
+        REQUIRE(ecs.attach(grandchild, dead) == ecs::error::not_found);
+        REQUIRE(ecs.parent(grandchild) == child);
+        REQUIRE(ecs.hierarchy().size() == 3);
+    }
+
+    SECTION("destroy orphans children") {
+        REQUIRE(ecs.destroy(child) == ecs::error::ok);
+        REQUIRE(ecs.parent(grandchild) == ecs::null_entity);
+        REQUIRE(ecs.contains<position>(grandchild));
+    }
+
+    SECTION("destroy subtree") {
+        REQUIRE(ecs.destroy_subtree(child) == ecs::error::ok);
+        REQUIRE(ecs.hierarchy().size() == 1);
+        REQUIRE_FALSE(ecs.contains<position>(child));
+        REQUIRE_FALSE(ecs.contains<position>(grandchild));
+        REQUIRE_FALSE(ecs.contains<velocity>(grandchild));
+        REQUIRE(ecs.contains<position>(root));
+        REQUIRE(ecs.destroy(child) == ecs::error::not_found);
+    }
+
+    SECTION("clear") {
+        REQUIRE(ecs.clear() == ecs::error::ok);
+        REQUIRE(ecs.hierarchy().size() == 0);
+    }
+}
+
+TEST_CASE("prefab", "[ecs]") {
+    ecs::ecs ecs;
+
+    SECTION("instantiate") {
+        ecs::prefab prefab;
+        prefab.set(position{1, 2}).set(velocity{3, 4}).set(enemy{});
+        REQUIRE(prefab.size() == 3);
+
+        auto const entities = ecs.instantiate(prefab, 10);
+        REQUIRE(entities.has_value());
+        REQUIRE(entities->size() == 10);
+        for (auto const e: *entities) {
+            REQUIRE(ecs.all_of<position, velocity, enemy>(e));
+            auto const [pos, vel] = ecs.get_multiple<position, velocity>(e);
+            REQUIRE(pos.dx == 1);
+            REQUIRE(vel.dy == 4);
+        }
+    }
+
+    SECTION("replace value") {
+        ecs::prefab prefab;
+        prefab.set(position{1, 1}).set(position{5, 5});
+        REQUIRE(prefab.size() == 1);
+        auto const entities = ecs.instantiate(prefab, 1);
+        REQUIRE(ecs.get<position>(entities->front()).dx == 5);
+    }
+
+    SECTION("from entity") {
+        auto const e = ecs.create();
+        REQUIRE(ecs.insert(e, position{7, 7}) == ecs::error::ok);
+        REQUIRE(ecs.insert(e, render_target{8, 8}) == ecs::error::ok);
+
+        auto const prefab = ecs.make_prefab<position, render_target>(e);
+        REQUIRE(prefab.has_value());
+        REQUIRE(prefab->contains<render_target>());
+        REQUIRE_FALSE(prefab->contains<velocity>());
+        REQUIRE(ecs.make_prefab<velocity>(e).error() == ecs::error::not_found);
+
+        auto const entities = ecs.instantiate(*prefab, 3);
+        REQUIRE(entities.has_value());
+        for (auto const instance: *entities) {
+            REQUIRE(ecs.get<render_target>(instance).w == 8);
+        }
+        REQUIRE(ecs.view<position>().begin() != ecs.view<position>().end());
+    }
+
+    SECTION("override") {
+        ecs::prefab prefab;
+        prefab.set(position{});
+        auto const entities = ecs.instantiate(prefab, 4, [&ecs](ecs::entity e, std::size_t i) {
+            ecs.get<position>(e).dx = static_cast<int>(i);
+        });
+        REQUIRE(entities.has_value());
+        for (std::size_t i = 0; i < entities->size(); ++i) {
+            REQUIRE(ecs.get<position>((*entities)[i]).dx == static_cast<int>(i));
+        }
+    }
+
+    SECTION("too many") {
+        ecs::prefab prefab;
+        prefab.set(position{});
+        auto const entities = ecs.instantiate(prefab, ecs::ENTITY_COUNT + 1);
+        REQUIRE_FALSE(entities.has_value());
+        REQUIRE(entities.error() == ecs::error::max_entities);
+        REQUIRE(ecs.view<position>().begin() == ecs.view<position>().end());
+    }
+
+    SECTION("out of handles") {
+        // 8 index bits hand out 255 handles, which the pools could all hold
+        using small_config = ecs::basic_config<std::uint16_t, 8, 64, 255>;
+        ecs::basic_ecs<small_config> small;
+        ecs::basic_prefab<small_config> prefab;
+        prefab.set(position{});
+        REQUIRE(small.instantiate(prefab, 100).has_value());
+        auto const entities = small.instantiate(prefab, 200);
+        REQUIRE_FALSE(entities.has_value());
+        REQUIRE(entities.error() == ecs::error::max_entities);
+        REQUIRE(small.query<position>().size() == 100);
+        REQUIRE(small.instantiate(prefab, 100).has_value());
+    }
+}
+
+TEST_CASE("config", "[ecs]") {
+    SECTION("compact handles") {
+        using small_config = ecs::basic_config<std::uint16_t, 4, 64, 512>;
+        ecs::basic_ecs<small_config> small;
+        STATIC_REQUIRE(std::is_same_v<decltype(small.create()), std::uint16_t>);
+
+        auto const e = small.create();
+        REQUIRE(small.insert(e, position{1, 2}) == ecs::error::ok);
+        REQUIRE(small.emplace<enemy>(e) == ecs::error::ok);
+        REQUIRE(small.destroy(e) == ecs::error::ok);
+
+        auto const recycled = small.create();
+        REQUIRE(small_config::to_index(recycled) == small_config::to_index(e));
+        REQUIRE(small.emplace<enemy>(recycled) == ecs::error::ok);
+        // the stale handle does not alias the recycled entity
+        REQUIRE_FALSE(small.contains<enemy>(e));
+        REQUIRE(small.contains<enemy>(recycled));
+
+        auto view = small.view<enemy>();
+        REQUIRE(std::distance(view.begin(), view.end()) == 1);
+    }
+
+    SECTION("limits") {
+        using tiny_config = ecs::basic_config<std::uint16_t, 0, 8, 16>;
+        ecs::basic_ecs<tiny_config> tiny;
+        for (int i = 0; i < 16; i++) {
+            REQUIRE(tiny.insert(tiny.create(), position{}) == ecs::error::ok);
+        }
+        REQUIRE(tiny.insert(tiny.create(), position{}) == ecs::error::max_entities);
+        REQUIRE(tiny.stats().front().bytes_reserved == 16 * sizeof(position));
+    }
+
+    SECTION("wide handles") {
+        using wide_config = ecs::basic_config<std::uint64_t, 32>;
+        ecs::basic_ecs<wide_config> wide;
+        auto const parent = wide.create();
+        auto const child = wide.create();
+        REQUIRE(wide.insert(child, velocity{3, 3}) == ecs::error::ok);
+        REQUIRE(wide.attach(child, parent) == ecs::error::ok);
+        REQUIRE(wide.destroy_subtree(parent) == ecs::error::ok);
+        auto const recycled = wide.create();
+        REQUIRE(wide_config::to_version(recycled) == 1);
+        REQUIRE_FALSE(wide.contains<velocity>(child));
+    }
+}
@@ -0,0 +1,182 @@
+//
+// Created by HP on 19.10.2026.
+//
+#include "entity.hpp"
+#include <algorithm>
+#include <catch2/catch_all.hpp>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+TEST_CASE("concurrent entity store", "[entity]") {
+    ecs::concurrent_entity_store store;
+
+    SECTION("create unique") {
+        std::unordered_set<ecs::entity> entities;
+        for (int i = 0; i < 100; i++) {
+            REQUIRE(entities.insert(store.create()).second);
+        }
+        REQUIRE(store.size() == 100);
+    }
+
+    SECTION("destroy") {
+        auto const e = store.create();
+        REQUIRE(store.contains(e));
+        REQUIRE(store.destroy(e) == ecs::error::ok);
+        REQUIRE_FALSE(store.contains(e));
+        REQUIRE(store.destroy(e) == ecs::error::not_found);
+        REQUIRE(store.size() == 0);
+    }
+
+    SECTION("reuse destroyed") {
+        std::vector<ecs::entity> entities;
+        for (int i = 0; i < 64; i++) {
+            entities.emplace_back(store.create());
+        }
+        for (auto const e: entities) {
+            REQUIRE(store.destroy(e) == ecs::error::ok);
+        }
+        for (int i = 0; i < 64; i++) {
+            auto const e = store.create();
+            REQUIRE(std::find(entities.begin(), entities.end(), e) != entities.end());
+        }
+    }
+
+    SECTION("iterate") {
+        std::unordered_set<ecs::entity> entities;
+        for (int i = 0; i < 50; i++) {
+            entities.insert(store.create());
+        }
+        std::size_t count{};
+        for (auto const e: store) {
+            REQUIRE(entities.contains(e));
+            ++count;
+        }
+        REQUIRE(count == entities.size());
+    }
+
+    SECTION("clear") {
+        for (int i = 0; i < 50; i++) {
+            (void) store.create();
+        }
+        REQUIRE(store.clear() == ecs::error::ok);
+        REQUIRE(store.size() == 0);
+        REQUIRE(store.begin() == store.end());
+    }
+
+    SECTION("stress") {
+        constexpr int thread_count = 8;
+        constexpr int iterations = 5000;
+        std::vector<std::vector<ecs::entity>> survivors(thread_count);
+        std::vector<std::thread> threads;
+
+        for (int t = 0; t < thread_count; t++) {
+            threads.emplace_back([&store, &survivors, t] {
+                std::vector<ecs::entity> own;
+                for (int i = 0; i < iterations; i++) {
+                    own.emplace_back(store.create());
+                    // destroy every second entity to exercise the free lists
+                    if (i % 2 == 1) {
+                        auto const e = own[own.size() - 2];
+                        own[own.size() - 2] = own.back();
+                        own.pop_back();
+                        if (store.destroy(e) != ecs::error::ok) {
+                            return;
+                        }
+                    }
+                }
+                survivors[t] = std::move(own);
+            });
+        }
+        for (auto &thread: threads) {
+            thread.join();
+        }
+
+        std::unordered_set<ecs::entity> unique;
+        for (auto const &own: survivors) {
+            REQUIRE(own.size() == iterations / 2);
+            for (auto const e: own) {
+                REQUIRE(unique.insert(e).second);
+                REQUIRE(store.contains(e));
+            }
+        }
+        REQUIRE(store.size() == unique.size());
+    }
+}
+
+TEST_CASE("entity versions", "[entity]") {
+    using config = ecs::basic_config<std::uint16_t, 4, 64, 1024>;
+    ecs::basic_entity_store<config> store;
+
+    SECTION("split") {
+        STATIC_REQUIRE(config::index_bits == 12);
+        STATIC_REQUIRE(config::to_index(config::make_entity(5, 3)) == 5);
+        STATIC_REQUIRE(config::to_version(config::make_entity(5, 3)) == 3);
+        STATIC_REQUIRE(config::to_version(config::next_version(config::make_entity(5, 15))) == 0);
+    }
+
+    SECTION("recycled handles differ") {
+        auto const e = store.create();
+        REQUIRE(store.destroy(e) == ecs::error::ok);
+        auto const recycled = store.create();
+        REQUIRE(config::to_index(recycled) == config::to_index(e));
+        REQUIRE(config::to_version(recycled) == 1);
+        REQUIRE_FALSE(store.contains(e));
+        REQUIRE(store.destroy(e) == ecs::error::not_found);
+    }
+
+    SECTION("index space exhausted") {
+        for (std::size_t i = 0; i < config::index_mask; i++) {
+            REQUIRE(store.create() != config::null);
+        }
+        REQUIRE(store.create() == config::null);
+    }
+
+    SECTION("without versions") {
+        ecs::entity_store plain;
+        auto const e = plain.create();
+        REQUIRE(plain.destroy(e) == ecs::error::ok);
+        REQUIRE(plain.create() == e);
+    }
+}
+
+TEST_CASE("recycle policy", "[entity]") {
+    ecs::entity_store store;
+    std::vector<ecs::entity> entities;
+    for (int i = 0; i < 8; i++) {
+        entities.push_back(store.create());
+    }
+    for (auto const i: {5, 1, 6, 3}) {
+        REQUIRE(store.destroy(entities[i]) == ecs::error::ok);
+    }
+
+    SECTION("fifo") {
+        REQUIRE(store.policy() == ecs::recycle_policy::fifo);
+        REQUIRE(store.create() == 5);
+        REQUIRE(store.create() == 1);
+    }
+
+    SECTION("lifo") {
+        store.set_policy(ecs::recycle_policy::lifo);
+        REQUIRE(store.create() == 3);
+        REQUIRE(store.create() == 6);
+    }
+
+    SECTION("lowest index") {
+        store.set_policy(ecs::recycle_policy::lowest_index);
+        REQUIRE(store.destroy(entities[0]) == ecs::error::ok);
+        REQUIRE(store.create() == 0);
+        REQUIRE(store.create() == 1);
+        REQUIRE(store.create() == 3);
+        REQUIRE(store.create() == 5);
+        REQUIRE(store.create() == 6);
+        REQUIRE(store.create() == 8);
+    }
+
+    SECTION("shrink to fit") {
+        store.shrink_to_fit();
+        REQUIRE(store.size() == 4);
+        REQUIRE(store.contains(entities[0]));
+        REQUIRE(store.create() == 5);
+    }
+}
@@ -0,0 +1,139 @@
+//
+// Created by HP on 19.10.2026.
+//
+#include "hierarchy.hpp"
+#include <algorithm>
+#include <catch2/catch_all.hpp>
+#include <random>
+#include <unordered_map>
+
+namespace {
+    // every parent is stored before its children and depths match the parent chain
+    bool is_depth_ordered(ecs::hierarchy const &hierarchy) {
+        std::unordered_map<ecs::entity, std::size_t> index;
+        for (std::size_t i = 0; i < hierarchy.size(); ++i) {
+            index[hierarchy.at(i)] = i;
+        }
+        for (std::size_t i = 0; i < hierarchy.size(); ++i) {
+            auto const &relation = hierarchy.relation_at(i);
+            if (relation.parent == ecs::null_entity) {
+                if (relation.depth != 0) {
+                    return false;
+                }
+                continue;
+            }
+            auto const parent_index = index.at(relation.parent);
+            if (parent_index >= i || hierarchy.relation_at(parent_index).depth + 1 != relation.depth) {
+                return false;
+            }
+        }
+        return true;
+    }
+} // namespace
+
+TEST_CASE("hierarchy", "[hierarchy]") {
+    ecs::hierarchy hierarchy;
+
+    SECTION("attach") {
+        REQUIRE(hierarchy.attach(1, 0) == ecs::error::ok);
+        REQUIRE(hierarchy.attach(2, 0) == ecs::error::ok);
+        REQUIRE(hierarchy.attach(3, 1) == ecs::error::ok);
+        REQUIRE(hierarchy.parent(1) == 0);
+        REQUIRE(hierarchy.parent(3) == 1);
+        REQUIRE(hierarchy.parent(0) == ecs::null_entity);
+        REQUIRE(hierarchy.find(3)->depth == 2);
+        auto children = hierarchy.children(0);
+        std::sort(children.begin(), children.end());
+        REQUIRE(children == std::vector<ecs::entity>{1, 2});
+        REQUIRE(is_depth_ordered(hierarchy));
+    }
+
+    SECTION("attach children first") {
+        REQUIRE(hierarchy.attach(3, 2) == ecs::error::ok);
+        REQUIRE(hierarchy.attach(2, 1) == ecs::error::ok);
+        REQUIRE(hierarchy.attach(1, 0) == ecs::error::ok);
+        REQUIRE(hierarchy.find(3)->depth == 3);
+        REQUIRE(hierarchy.depth() == 4);
+        REQUIRE(std::vector<ecs::entity>{hierarchy.begin(), hierarchy.end()} == std::vector<ecs::entity>{0, 1, 2, 3});
+    }
+
+    SECTION("reject cycles") {
+        REQUIRE(hierarchy.attach(1, 0) == ecs::error::ok);
+        REQUIRE(hierarchy.attach(2, 1) == ecs::error::ok);
+        REQUIRE(hierarchy.attach(0, 2) == ecs::error::failed);
+        REQUIRE(hierarchy.attach(0, 0) == ecs::error::failed);
+        REQUIRE(is_depth_ordered(hierarchy));
+    }
+
+    SECTION("reparent") {
+        REQUIRE(hierarchy.attach(1, 0) == ecs::error::ok);
+        REQUIRE(hierarchy.attach(2, 1) == ecs::error::ok);
+        REQUIRE(hierarchy.attach(3, 0) == ecs::error::ok);
+        REQUIRE(hierarchy.attach(1, 3) == ecs::error::ok);
+        REQUIRE(hierarchy.children(0) == std::vector<ecs::entity>{3});
+        REQUIRE(hierarchy.find(2)->depth == 3);
+        REQUIRE(is_depth_ordered(hierarchy));
+    }
+
+    SECTION("detach") {
+        REQUIRE(hierarchy.attach(1, 0) == ecs::error::ok);
+        REQUIRE(hierarchy.attach(2, 1) == ecs::error::ok);
+        REQUIRE(hierarchy.detach(1) == ecs::error::ok);
+        REQUIRE(hierarchy.parent(1) == ecs::null_entity);
+        REQUIRE(hierarchy.find(2)->depth == 1);
+        REQUIRE(hierarchy.children(0).empty());
+        REQUIRE(hierarchy.detach(7) == ecs::error::not_found);
+        REQUIRE(is_depth_ordered(hierarchy));
+    }
+
+    SECTION("remove orphans children") {
+        REQUIRE(hierarchy.attach(1, 0) == ecs::error::ok);
+        REQUIRE(hierarchy.attach(2, 1) == ecs::error::ok);
+        REQUIRE(hierarchy.attach(3, 1) == ecs::error::ok);
+        REQUIRE(hierarchy.remove(1) == ecs::error::ok);
+        REQUIRE_FALSE(hierarchy.contains(1));
+        REQUIRE(hierarchy.parent(2) == ecs::null_entity);
+        REQUIRE(hierarchy.parent(3) == ecs::null_entity);
+        REQUIRE(hierarchy.children(0).empty());
+        REQUIRE(is_depth_ordered(hierarchy));
+    }
+
+    SECTION("remove subtree") {
+        REQUIRE(hierarchy.attach(1, 0) == ecs::error::ok);
+        REQUIRE(hierarchy.attach(2, 1) == ecs::error::ok);
+        REQUIRE(hierarchy.attach(3, 2) == ecs::error::ok);
+        REQUIRE(hierarchy.attach(4, 0) == ecs::error::ok);
+        REQUIRE(hierarchy.subtree(1) == std::vector<ecs::entity>{1, 2, 3});
+        REQUIRE(hierarchy.remove_subtree(1) == ecs::error::ok);
+        REQUIRE(hierarchy.size() == 2);
+        REQUIRE(hierarchy.children(0) == std::vector<ecs::entity>{4});
+        REQUIRE(hierarchy.depth() == 2);
+        REQUIRE(is_depth_ordered(hierarchy));
+    }
+
+    SECTION("fuzzy") {
+        std::mt19937 generator{42};
+        std::uniform_int_distribution<ecs::entity> entities(0, 63);
+        std::uniform_int_distribution<int> operations(0, 9);
+
+        for (int i = 0; i < 2000; i++) {
+            auto const a = entities(generator);
+            auto const b = entities(generator);
+            switch (operations(generator)) {
+                case 0:
+                    hierarchy.detach(a);
+                    break;
+                case 1:
+                    hierarchy.remove(a);
+                    break;
+                case 2:
+                    hierarchy.remove_subtree(a);
+                    break;
+                default:
+                    hierarchy.attach(a, b);
+                    break;
+            }
+            REQUIRE(is_depth_ordered(hierarchy));
+        }
+    }
+}
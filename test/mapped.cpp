@@ -0,0 +1,232 @@
+//
+// Created by HP on 19.10.2026.
+//
+#include "mapped.hpp"
+#include <array>
+#include <catch2/catch_all.hpp>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "ecs.hpp"
+
+namespace {
+    struct sample {
+        int a{};
+        float b{};
+    };
+} // namespace
+
+TEST_CASE("mapped region", "[mapped]") {
+    ecs::mapped_region region{1 << 20};
+    REQUIRE(region.size() >= 1 << 20);
+    REQUIRE(region.committed() == 0);
+
+    region.commit(100);
+    REQUIRE(region.committed() >= 100);
+    region.data()[99] = std::byte{42};
+    region.commit(region.size());
+    region.data()[region.size() - 1] = std::byte{1};
+    REQUIRE(region.data()[99] == std::byte{42});
+
+    region.decommit(0);
+    REQUIRE(region.committed() == 0);
+    REQUIRE_THROWS_AS(region.commit(region.size() + 1), std::bad_alloc);
+
+    SECTION("move") {
+        auto other = std::move(region);
+        REQUIRE(region.data() == nullptr);
+        other.commit(1);
+        other.data()[0] = std::byte{7};
+    }
+
+    SECTION("huge pages") {
+        ecs::mapped_region transparent{4 << 20, ecs::huge_pages::transparent};
+        transparent.commit(transparent.size());
+        transparent.data()[0] = std::byte{1};
+        ecs::mapped_region hugetlb{4 << 20, ecs::huge_pages::hugetlb};
+        hugetlb.commit(1);
+        hugetlb.data()[0] = std::byte{1};
+    }
+}
+
+TEST_CASE("mapped storage", "[mapped]") {
+    SECTION("anonymous") {
+        ecs::mapped_storage<std::string, 64, 1000> storage;
+        REQUIRE(storage.capacity() == 0);
+        storage.reserve(65);
+        REQUIRE(storage.capacity() == 128);
+        REQUIRE(storage.page_count() == 2);
+        REQUIRE(storage[127].empty());
+        storage[0] = "first";
+        auto const *first = &storage[0];
+        storage.reserve(900);
+        REQUIRE(&storage[0] == first);
+        storage.fill(10, 100, "x");
+        REQUIRE(storage[109] == "x");
+        storage.shrink(1);
+        REQUIRE(storage.capacity() == 64);
+        REQUIRE(storage[0] == "first");
+        REQUIRE_THROWS_AS(storage.reserve(1025), std::bad_alloc);
+    }
+
+    SECTION("raw") {
+        ecs::raw_mapped_storage<64, 1000> storage{12, 4};
+        REQUIRE(storage.stride() == 12);
+        storage.reserve(100);
+        REQUIRE(storage.capacity() == 128);
+        *static_cast<int *>(storage[99]) = 7;
+        storage.shrink(64);
+        REQUIRE(storage.capacity() == 64);
+        REQUIRE_THROWS_AS((ecs::raw_mapped_storage<64, 1000>{4, 8192}), std::invalid_argument);
+    }
+
+    SECTION("vector") {
+        ecs::mapped_vector<int, 100'000> vector;
+        REQUIRE(vector.empty());
+        REQUIRE(vector.capacity() == 0);
+        for (int i = 0; i < 5000; i++) {
+            vector.push_back(i);
+        }
+        auto const *data = vector.data();
+        vector.push_back(5000);
+        REQUIRE(vector.data() == data);
+        REQUIRE(vector.size() == 5001);
+        REQUIRE(vector.back() == 5000);
+        vector.erase(vector.begin(), vector.begin() + 1000);
+        REQUIRE(vector.size() == 4001);
+        REQUIRE(vector[0] == 1000);
+        vector.pop_back();
+        REQUIRE(std::span<int const>{vector}.back() == 4999);
+        vector.clear();
+        vector.shrink_to_fit();
+        REQUIRE(vector.capacity() == 0);
+        REQUIRE_THROWS_AS(vector.reserve(100'001), std::bad_alloc);
+    }
+
+    SECTION("file backed") {
+        auto const path = std::filesystem::temp_directory_path() / "ecs_mapped_storage_test.bin";
+        std::filesystem::remove(path);
+        {
+            ecs::mapped_storage<sample, 64, 1000> storage{path};
+            storage.reserve(200);
+            for (int i = 0; i < 200; i++) {
+                storage[i] = sample{i, static_cast<float>(i) / 2};
+            }
+            storage.flush();
+        }
+        {
+            ecs::mapped_storage<sample, 64, 1000> reopened{path};
+            reopened.reserve(200);
+            REQUIRE(reopened[0].a == 0);
+            REQUIRE(reopened[199].a == 199);
+            REQUIRE(reopened[199].b == 99.5f);
+        }
+        std::filesystem::remove(path);
+    }
+}
+
+TEST_CASE("mapped world", "[mapped]") {
+    using config = ecs::basic_config<std::uint32_t, 8, 256, 100'000, memory_layout::basic_compressed,
+                                     ecs::mapped_backend<ecs::huge_pages::transparent>>;
+    ecs::basic_ecs<config> ecs;
+
+    std::vector<config::entity_type> entities;
+    for (int i = 0; i < 1000; i++) {
+        entities.push_back(ecs.create());
+        REQUIRE(ecs.insert(entities.back(), sample{i, 0}) == ecs::error::ok);
+    }
+    REQUIRE(ecs.erase<sample>(entities[0]) == ecs::error::ok);
+    REQUIRE(ecs.get<sample>(entities[1]).a == 1);
+
+    int total = 0;
+    ecs.view<sample>().each<sample>([&total](sample const &s) { total += s.a; });
+    REQUIRE(total == 999 * 1000 / 2);
+
+    auto const stats = ecs.stats().front();
+    REQUIRE(stats.bytes_reserved == 1024 * sizeof(sample));
+    for (std::size_t i = 1; i < entities.size(); i++) {
+        REQUIRE(ecs.destroy(entities[i]) == ecs::error::ok);
+    }
+    ecs.compact();
+    REQUIRE(ecs.stats().front().bytes_reserved == 0);
+}
+
+TEST_CASE("mapped sparse world", "[mapped]") {
+    // index, values and runtime components all live in reserved address space
+    using config = ecs::basic_config<std::uint32_t, 8, 256, 100'000, memory_layout::basic_sparse,
+                                     ecs::mapped_backend<>>;
+    STATIC_REQUIRE(std::is_same_v<config::raw_storage_type, ecs::raw_mapped_storage<256, 100'000>>);
+    ecs::basic_ecs<config> ecs;
+    auto const id = ecs.register_component({.name = "vec2", .size = 8, .alignment = 4});
+
+    std::vector<config::entity_type> entities;
+    for (int i = 0; i < 1000; i++) {
+        entities.push_back(ecs.create());
+        REQUIRE(ecs.insert(entities.back(), sample{i, 0}) == ecs::error::ok);
+        std::array<float, 2> const value{static_cast<float>(i), 1};
+        REQUIRE(ecs.insert(id, entities.back(), value.data()) == ecs::error::ok);
+    }
+    REQUIRE(ecs.destroy(entities[0]) == ecs::error::ok);
+    REQUIRE_FALSE(ecs.contains<sample>(entities[0]));
+    REQUIRE(ecs.get<sample>(entities[999]).a == 999);
+    REQUIRE(static_cast<float const *>(ecs.try_get(id, entities[500]))[0] == 500);
+
+    // recycled index with a new version
+    auto const recycled = ecs.create();
+    REQUIRE(config::to_index(recycled) == config::to_index(entities[0]));
+    REQUIRE(ecs.insert(recycled, sample{-1, 0}) == ecs::error::ok);
+    REQUIRE_FALSE(ecs.contains<sample>(entities[0]));
+    REQUIRE(ecs.get<sample>(recycled).a == -1);
+}
+
+TEST_CASE("mapped entity store", "[mapped]") {
+    // the store hands out at most MaxEntities indices, so its reservation stays bounded
+    using config = ecs::basic_config<std::uint32_t, 8, 256, 1000, memory_layout::basic_sparse, ecs::mapped_backend<>>;
+    STATIC_REQUIRE(config::index_count == 1000);
+    STATIC_REQUIRE(std::is_same_v<config::vector_type<int>, ecs::mapped_vector<int, 1000>>);
+    ecs::basic_entity_store<config> store;
+
+    std::vector<config::entity_type> entities;
+    for (int i = 0; i < 1000; i++) {
+        entities.push_back(store.create());
+        REQUIRE(entities.back() != config::null);
+    }
+    REQUIRE(store.create() == config::null);
+    REQUIRE(store.size() == 1000);
+
+    for (std::size_t i = 0; i < entities.size(); i += 2) {
+        REQUIRE(store.destroy(entities[i]) == ecs::error::ok);
+    }
+    REQUIRE(store.size() == 500);
+    REQUIRE_FALSE(store.contains(entities[0]));
+    REQUIRE(store.contains(entities[1]));
+    REQUIRE(std::unordered_set<config::entity_type>{store.begin(), store.end()}.size() == 500);
+
+    // fifo drops the taken part of the free list while recycling
+    for (int round = 0; round < 10; round++) {
+        for (int i = 0; i < 400; i++) {
+            auto const e = store.create();
+            REQUIRE(config::to_index(e) % 2 == 0);
+            REQUIRE(store.destroy(e) == ecs::error::ok);
+        }
+    }
+    store.shrink_to_fit();
+    REQUIRE(store.contains(entities[999]));
+    std::vector<config::entity_type> recycled;
+    for (int i = 0; i < 500; i++) {
+        recycled.push_back(store.create());
+        REQUIRE(recycled.back() != config::null);
+    }
+    REQUIRE(store.create() == config::null);
+    for (auto const e: recycled) {
+        REQUIRE(store.destroy(e) == ecs::error::ok);
+    }
+
+    store.set_policy(ecs::recycle_policy::lowest_index);
+    REQUIRE(config::to_index(store.create()) == 0);
+    REQUIRE(store.clear() == ecs::error::ok);
+    REQUIRE(store.size() == 0);
+    REQUIRE(config::to_index(store.create()) == 0);
+}
@@ -0,0 +1,119 @@
+//
+// Created by HP on 19.10.2026.
+//
+#include "spatial.hpp"
+#include <algorithm>
+#include <catch2/catch_all.hpp>
+#include <random>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+    float distance2(ecs::point const &a, ecs::point const &b) {
+        auto const dx = a[0] - b[0];
+        auto const dy = a[1] - b[1];
+        return dx * dx + dy * dy;
+    }
+
+    std::unordered_set<ecs::entity> as_set(std::vector<ecs::entity> const &entities) {
+        return {entities.begin(), entities.end()};
+    }
+} // namespace
+
+TEST_CASE("spatial grid", "[spatial]") {
+    ecs::spatial_grid grid{10.0f};
+    grid.update(0, {1, 1});
+    grid.update(1, {5, 5});
+    grid.update(2, {25, 0});
+    grid.update(3, {-12, -3});
+
+    SECTION("update") {
+        REQUIRE(grid.size() == 4);
+        REQUIRE(grid.contains(2));
+        REQUIRE(grid.position(2).value() == ecs::point{25, 0});
+        grid.update(2, {0, 2});
+        REQUIRE(grid.size() == 4);
+        REQUIRE(grid.position(2).value() == ecs::point{0, 2});
+        REQUIRE(as_set(grid.radius({0, 0}, 3)) == std::unordered_set<ecs::entity>{0, 2});
+    }
+
+    SECTION("remove") {
+        REQUIRE(grid.remove(1) == ecs::error::ok);
+        REQUIRE(grid.remove(1) == ecs::error::not_found);
+        REQUIRE_FALSE(grid.contains(1));
+        REQUIRE(grid.position(1).error() == ecs::error::not_found);
+        REQUIRE(as_set(grid.radius({0, 0}, 10)) == std::unordered_set<ecs::entity>{0});
+    }
+
+    SECTION("radius") {
+        REQUIRE(as_set(grid.radius({0, 0}, 8)) == std::unordered_set<ecs::entity>{0, 1});
+        REQUIRE(as_set(grid.radius({0, 0}, 13)) == std::unordered_set<ecs::entity>{0, 1, 3});
+        REQUIRE(grid.radius({100, 100}, 5).empty());
+        REQUIRE(grid.radius({0, 0}, 1000).size() == 4);
+    }
+
+    SECTION("aabb") {
+        REQUIRE(as_set(grid.aabb({0, 0}, {30, 5})) == std::unordered_set<ecs::entity>{0, 1, 2});
+        REQUIRE(as_set(grid.aabb({-20, -20}, {0, 0})) == std::unordered_set<ecs::entity>{3});
+    }
+
+    SECTION("nearest") {
+        REQUIRE(grid.nearest({0, 0}, 2) == std::vector<ecs::entity>{0, 1});
+        REQUIRE(grid.nearest({30, 0}, 1) == std::vector<ecs::entity>{2});
+        REQUIRE(grid.nearest({0, 0}, 10).size() == 4);
+        REQUIRE(grid.nearest({1e6f, 1e6f}, 1) == std::vector<ecs::entity>{2});
+        REQUIRE(grid.nearest({0, 0}, 0).empty());
+    }
+
+    SECTION("clear") {
+        grid.clear();
+        REQUIRE(grid.size() == 0);
+        REQUIRE(grid.nearest({0, 0}, 1).empty());
+    }
+
+    SECTION("invalid cell size") {
+        REQUIRE_THROWS_AS(ecs::spatial_grid{0.0f}, std::invalid_argument);
+    }
+
+    SECTION("fuzzy") {
+        std::mt19937 generator{7};
+        std::uniform_real_distribution<float> coordinates(-200, 200);
+        std::uniform_int_distribution<ecs::entity> entities(0, 255);
+        std::unordered_map<ecs::entity, ecs::point> expected{{0, {1, 1}}, {1, {5, 5}}, {2, {25, 0}}, {3, {-12, -3}}};
+
+        for (int i = 0; i < 500; ++i) {
+            auto const e = entities(generator);
+            if (i % 4 == 0) {
+                grid.remove(e);
+                expected.erase(e);
+            } else {
+                ecs::point const p{coordinates(generator), coordinates(generator)};
+                grid.update(e, p);
+                expected[e] = p;
+            }
+            REQUIRE(grid.size() == expected.size());
+        }
+
+        for (int i = 0; i < 50; ++i) {
+            ecs::point const center{coordinates(generator), coordinates(generator)};
+            auto const r = coordinates(generator) / 4 + 50;
+
+            std::unordered_set<ecs::entity> in_radius;
+            std::vector<std::pair<float, ecs::entity>> by_distance;
+            for (auto const &[e, p]: expected) {
+                if (distance2(p, center) <= r * r) {
+                    in_radius.insert(e);
+                }
+                by_distance.emplace_back(distance2(p, center), e);
+            }
+            std::sort(by_distance.begin(), by_distance.end());
+            REQUIRE(as_set(grid.radius(center, r)) == in_radius);
+
+            auto const nearest = grid.nearest(center, 5);
+            REQUIRE(nearest.size() == std::min<std::size_t>(5, expected.size()));
+            for (std::size_t j = 0; j < nearest.size(); ++j) {
+                REQUIRE(distance2(expected.at(nearest[j]), center) == by_distance[j].first);
+            }
+        }
+    }
+}